@@ -103,7 +103,7 @@ INCLUDEPATH += $$PWD/../atools/src $$PWD/src
 win32 {
 DEFINES += _USE_MATH_DEFINES
   LIBS += -L $$PWD/../build-atools-$${CONF_TYPE}/$${CONF_TYPE} -l atools
-  LIBS += -lz
+  LIBS += -lz -lsqlite3
   PRE_TARGETDEPS += $$PWD/../build-atools-$${CONF_TYPE}/$${CONF_TYPE}/libatools.a
   WINDEPLOY_FLAGS = --compiler-runtime
 }
@@ -114,13 +114,13 @@ unix {
 }
 unix:!macx {
   INCLUDEPATH += $$MARBLE_BASE/include
-  LIBS += -L$$MARBLE_BASE/lib -lmarblewidget-qt5 -lz
+  LIBS += -L$$MARBLE_BASE/lib -lmarblewidget-qt5 -lz -lsqlite3
   DEPENDPATH += $$MARBLE_BASE/include
 }
 
 macx {
   INCLUDEPATH += $$MARBLE_BASE/include
-  LIBS += -L$$MARBLE_BASE/lib -lmarblewidget-qt5 -lz
+  LIBS += -L$$MARBLE_BASE/lib -lmarblewidget-qt5 -lz -lsqlite3
   DEPENDPATH += $$MARBLE_BASE/include
 }
 
@@ -248,7 +248,18 @@ SOURCES += src/main.cpp\
     src/common/jumpback.cpp \
     src/perf/aircraftperfdialog.cpp \
     src/perf/aircraftperfcontroller.cpp \
-    src/common/unitstringtool.cpp
+    src/common/unitstringtool.cpp \
+    src/common/paintstatistics.cpp \
+    src/mapgui/mapdetailgovernor.cpp \
+    src/mapgui/mappaintbudget.cpp \
+    src/connect/simdatasnapshot.cpp \
+    src/connect/simdatarecorder.cpp \
+    src/connect/simdatareplay.cpp \
+    src/connect/simdatagenerator.cpp \
+    src/connect/simdataserver.cpp \
+    src/connect/simdatadispatcher.cpp \
+    src/query/identindex.cpp \
+    src/search/sqlqueryworker.cpp
 
 HEADERS  += src/gui/mainwindow.h \
     src/search/columnlist.h \
@@ -363,7 +374,18 @@ HEADERS  += src/gui/mainwindow.h \
     src/common/jumpback.h \
     src/perf/aircraftperfdialog.h \
     src/perf/aircraftperfcontroller.h \
-    src/common/unitstringtool.h
+    src/common/unitstringtool.h \
+    src/common/paintstatistics.h \
+    src/mapgui/mapdetailgovernor.h \
+    src/mapgui/mappaintbudget.h \
+    src/connect/simdatasnapshot.h \
+    src/connect/simdatarecorder.h \
+    src/connect/simdatareplay.h \
+    src/connect/simdatagenerator.h \
+    src/connect/simdataserver.h \
+    src/connect/simdatadispatcher.h \
+    src/query/identindex.h \
+    src/search/sqlqueryworker.h
 
 FORMS    += src/gui/mainwindow.ui \
     src/db/databasedialog.ui \
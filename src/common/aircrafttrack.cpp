@@ -24,15 +24,22 @@
 #include <QDataStream>
 #include <QDateTime>
 #include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <cstring>
+
+/* Minimum distance between positions for each simplified level starting with level 1 */
+const static QVector<float> LEVEL_MIN_DISTANCE_METER({250.f, 1000.f, 4000.f, 16000.f, 64000.f});
 
 AircraftTrack::AircraftTrack()
 {
-
+  levels.resize(LEVEL_MIN_DISTANCE_METER.size());
 }
 
 AircraftTrack::~AircraftTrack()
 {
-
+  closeJournal();
 }
 
 namespace at {
@@ -53,48 +60,44 @@ QDataStream& operator<<(QDataStream& dataStream, const at::AircraftTrackPos& tra
 
 void AircraftTrack::saveState()
 {
-  QFile trackFile(atools::settings::Settings::getConfigFilename(".track"));
-
-  if(trackFile.open(QIODevice::WriteOnly))
-  {
-    QDataStream out(&trackFile);
-    out.setVersion(QDataStream::Qt_5_5);
-    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
-
-    out << FILE_MAGIC_NUMBER << FILE_VERSION << *this;
-    trackFile.close();
-  }
-  else
-    qWarning() << "Cannot write track" << trackFile.fileName() << ":" << trackFile.errorString();
+  // Positions are written while flying - rewrite only if the file does not match the track
+  if(!journalSynced)
+    compactJournal();
+  closeJournal();
 }
 
 void AircraftTrack::restoreState()
 {
-  clear();
+  clearInternal();
+  closeJournal();
+  journalSynced = false;
+  journalRecords = 0;
 
-  QFile trackFile(atools::settings::Settings::getConfigFilename(".track"));
+  QFile trackFile(journalFilename());
   if(trackFile.exists())
   {
     if(trackFile.open(QIODevice::ReadOnly))
     {
-      quint32 magic;
-      quint16 version;
-      QDataStream in(&trackFile);
-      in.setVersion(QDataStream::Qt_5_5);
-      in.setFloatingPointPrecision(QDataStream::SinglePrecision);
-      in >> magic;
-
-      if(magic == FILE_MAGIC_NUMBER)
+      if(trackFile.size() >= JOURNAL_HEADER_SIZE)
       {
-        in >> version;
-        if(version == FILE_VERSION)
-          in >> *this;
+        // Map file into memory - only the pages for the header and the last positions are read
+        uchar *data = trackFile.map(0, trackFile.size());
+        if(data != nullptr)
+        {
+          if(qFromLittleEndian<quint32>(data) == FILE_MAGIC_NUMBER &&
+             qFromLittleEndian<quint16>(data + 4) == JOURNAL_FILE_VERSION)
+            readJournal(data, trackFile.size());
+          else if(qFromBigEndian<quint32>(data) == FILE_MAGIC_NUMBER)
+            // Old format written by QDataStream - converted to journal on first write
+            readLegacy(trackFile);
+          else
+            qWarning() << "Cannot read track" << trackFile.fileName() << ". Invalid magic number or version";
+
+          trackFile.unmap(data);
+        }
         else
-          qWarning() << "Cannot read track" << trackFile.fileName() << ". Invalid version number:" << version;
+          qWarning() << "Cannot map track" << trackFile.fileName() << ":" << trackFile.errorString();
       }
-      else
-        qWarning() << "Cannot read track" << trackFile.fileName() << ". Invalid magic number:" << magic;
-
       trackFile.close();
     }
     else
@@ -102,6 +105,199 @@ void AircraftTrack::restoreState()
   }
 }
 
+void AircraftTrack::readJournal(const uchar *data, qint64 size)
+{
+  qint64 numRecords = (size - JOURNAL_HEADER_SIZE) / JOURNAL_RECORD_SIZE;
+  bool partial = (size - JOURNAL_HEADER_SIZE) % JOURNAL_RECORD_SIZE != 0;
+
+  // Read only the positions which fit into the ring buffer
+  qint64 firstRecord = std::max(static_cast<qint64>(0), numRecords - (maxTrackEntries + 1));
+  int numInvalid = 0;
+  for(qint64 i = firstRecord; i < numRecords; i++)
+  {
+    at::AircraftTrackPos trackPos;
+    if(decodeRecord(data + JOURNAL_HEADER_SIZE + i * JOURNAL_RECORD_SIZE, trackPos))
+      appendInternal(trackPos);
+    else
+      numInvalid++;
+  }
+
+  if(partial || numInvalid > 0)
+    // Crash while writing or damaged file - rewrite on next append or save
+    qWarning() << Q_FUNC_INFO << "Track journal has" << numInvalid << "invalid records. Partial record:" << partial;
+
+  journalRecords = static_cast<int>(numRecords);
+  journalSynced = !partial && numInvalid == 0;
+
+  qDebug() << Q_FUNC_INFO << "Read" << numEntries << "of" << numRecords << "track positions";
+}
+
+void AircraftTrack::readLegacy(QFile& trackFile)
+{
+  quint32 magic;
+  quint16 version;
+  QDataStream in(&trackFile);
+  in.setVersion(QDataStream::Qt_5_5);
+  in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+  in >> magic >> version;
+
+  if(version == FILE_VERSION)
+  {
+    // Same format as a serialized QList
+    quint32 num;
+    in >> num;
+    for(quint32 i = 0; i < num && in.status() == QDataStream::Ok; i++)
+    {
+      at::AircraftTrackPos trackPos;
+      in >> trackPos;
+      appendInternal(trackPos);
+    }
+  }
+  else
+    qWarning() << "Cannot read track" << trackFile.fileName() << ". Invalid version number:" << version;
+}
+
+QString AircraftTrack::journalFilename() const
+{
+  return atools::settings::Settings::getConfigFilename(".track");
+}
+
+void AircraftTrack::encodeRecord(uchar *record, const at::AircraftTrackPos& trackPos)
+{
+  float lonX = trackPos.pos.getLonX(), latY = trackPos.pos.getLatY(), alt = trackPos.pos.getAltitude();
+  quint32 value;
+
+  std::memcpy(&value, &lonX, sizeof(value));
+  qToLittleEndian<quint32>(value, record);
+  std::memcpy(&value, &latY, sizeof(value));
+  qToLittleEndian<quint32>(value, record + 4);
+  std::memcpy(&value, &alt, sizeof(value));
+  qToLittleEndian<quint32>(value, record + 8);
+  qToLittleEndian<quint32>(trackPos.timestamp, record + 12);
+  record[16] = trackPos.onGround ? 1 : 0;
+  record[17] = 0;
+  qToLittleEndian<quint16>(qChecksum(reinterpret_cast<const char *>(record), JOURNAL_RECORD_SIZE - 2), record + 18);
+}
+
+bool AircraftTrack::decodeRecord(const uchar *record, at::AircraftTrackPos& trackPos)
+{
+  if(qFromLittleEndian<quint16>(record + 18) !=
+     qChecksum(reinterpret_cast<const char *>(record), JOURNAL_RECORD_SIZE - 2))
+    return false;
+
+  float lonX, latY, alt;
+  quint32 value = qFromLittleEndian<quint32>(record);
+  std::memcpy(&lonX, &value, sizeof(lonX));
+  value = qFromLittleEndian<quint32>(record + 4);
+  std::memcpy(&latY, &value, sizeof(latY));
+  value = qFromLittleEndian<quint32>(record + 8);
+  std::memcpy(&alt, &value, sizeof(alt));
+
+  trackPos.pos = atools::geo::Pos(lonX, latY, alt);
+  trackPos.timestamp = qFromLittleEndian<quint32>(record + 12);
+  trackPos.onGround = record[16] != 0;
+  return true;
+}
+
+void AircraftTrack::writeJournal(const at::AircraftTrackPos& trackPos)
+{
+  if(!journalSynced || journalRecords > 2 * numEntries + PRUNE_TRACK_ENTRIES)
+    // File does not match the track or contains too many pruned positions - rewrite
+    compactJournal();
+  else
+  {
+    if(journalFile == nullptr)
+      openJournal();
+
+    if(journalFile != nullptr)
+    {
+      uchar record[JOURNAL_RECORD_SIZE];
+      encodeRecord(record, trackPos);
+
+      // Flush to keep the file consistent in case of a crash
+      if(journalFile->write(reinterpret_cast<const char *>(record), JOURNAL_RECORD_SIZE) == JOURNAL_RECORD_SIZE &&
+         journalFile->flush())
+        journalRecords++;
+      else
+      {
+        qWarning() << "Cannot write track" << journalFile->fileName() << ":" << journalFile->errorString();
+        closeJournal();
+        journalSynced = false;
+      }
+    }
+  }
+}
+
+void AircraftTrack::compactJournal()
+{
+  closeJournal();
+  journalSynced = false;
+
+  // Write into a temporary file which replaces the journal when finished
+  QSaveFile saveFile(journalFilename());
+  if(saveFile.open(QIODevice::WriteOnly))
+  {
+    QByteArray bytes(JOURNAL_HEADER_SIZE + numEntries * JOURNAL_RECORD_SIZE, '\0');
+    uchar *data = reinterpret_cast<uchar *>(bytes.data());
+    qToLittleEndian<quint32>(FILE_MAGIC_NUMBER, data);
+    qToLittleEndian<quint16>(JOURNAL_FILE_VERSION, data + 4);
+    qToLittleEndian<quint16>(JOURNAL_RECORD_SIZE, data + 6);
+
+    for(int i = 0; i < numEntries; i++)
+      encodeRecord(data + JOURNAL_HEADER_SIZE + i * JOURNAL_RECORD_SIZE, at(i));
+
+    if(saveFile.write(bytes) == bytes.size() && saveFile.commit())
+    {
+      journalRecords = numEntries;
+      journalSynced = true;
+    }
+    else
+      qWarning() << "Cannot write track" << saveFile.fileName() << ":" << saveFile.errorString();
+  }
+  else
+    qWarning() << "Cannot write track" << saveFile.fileName() << ":" << saveFile.errorString();
+}
+
+void AircraftTrack::openJournal()
+{
+  journalFile = new QFile(journalFilename());
+  if(!journalFile->open(QIODevice::WriteOnly | QIODevice::Append))
+  {
+    qWarning() << "Cannot open track" << journalFile->fileName() << ":" << journalFile->errorString();
+    delete journalFile;
+    journalFile = nullptr;
+    journalSynced = false;
+  }
+}
+
+void AircraftTrack::closeJournal()
+{
+  if(journalFile != nullptr)
+  {
+    journalFile->close();
+    delete journalFile;
+    journalFile = nullptr;
+  }
+}
+
+void AircraftTrack::clearTrack()
+{
+  clearInternal();
+
+  // Truncate the file
+  compactJournal();
+}
+
+void AircraftTrack::clearInternal()
+{
+  buffer.clear();
+  head = numEntries = 0;
+  firstSequence = 0;
+
+  for(QList<LevelPos>& level : levels)
+    level.clear();
+}
+
 bool AircraftTrack::appendTrackPos(const atools::geo::Pos& pos, const QDateTime& timestamp, bool onGround)
 {
   bool pruned = false;
@@ -110,7 +306,10 @@ bool AircraftTrack::appendTrackPos(const atools::geo::Pos& pos, const QDateTime&
   long timeDiff = onGround ? MIN_POSITION_TIME_DIFF_GROUND_MS : MIN_POSITION_TIME_DIFF_MS;
 
   if(isEmpty())
-    append({pos, timestamp.toTime_t(), onGround});
+  {
+    appendInternal({pos, timestamp.toTime_t(), onGround});
+    writeJournal(last());
+  }
   else
   {
     long time = timestamp.toMSecsSinceEpoch();
@@ -120,24 +319,108 @@ bool AircraftTrack::appendTrackPos(const atools::geo::Pos& pos, const QDateTime&
     {
       if(pos.distanceMeterTo(last().pos) > atools::geo::nmToMeter(MAX_POINT_DISTANCE_NM))
       {
-        clear();
+        clearTrack();
         pruned = true;
       }
-      else
-      {
-        if(size() > maxTrackEntries)
-        {
-          for(int i = 0; i < PRUNE_TRACK_ENTRIES; i++)
-            removeFirst();
-          pruned = true;
-        }
-      }
-      append({pos, timestamp.toTime_t(), onGround});
+      pruned |= appendInternal({pos, timestamp.toTime_t(), onGround});
+      writeJournal(last());
     }
   }
   return pruned;
 }
 
+bool AircraftTrack::appendInternal(const at::AircraftTrackPos& trackPos)
+{
+  bool pruned = false;
+  if(numEntries > maxTrackEntries)
+  {
+    // Drop a block of the oldest entries by moving the start of the ring
+    int numRemove = numEntries > PRUNE_TRACK_ENTRIES ? PRUNE_TRACK_ENTRIES : numEntries;
+    head = (head + numRemove) % buffer.size();
+    numEntries -= numRemove;
+    firstSequence += numRemove;
+    pruneLevels();
+    pruned = true;
+  }
+
+  if(numEntries < buffer.size())
+    // Use free slot in ring
+    buffer[(head + numEntries) % buffer.size()] = trackPos;
+  else
+    // Ring is not at maximum size yet - head is always 0 in this case
+    buffer.append(trackPos);
+  numEntries++;
+
+  appendLevels(trackPos, firstSequence + numEntries - 1);
+  return pruned;
+}
+
+void AircraftTrack::appendLevels(const at::AircraftTrackPos& trackPos, qint64 sequence)
+{
+  for(int i = 0; i < levels.size(); i++)
+  {
+    QList<LevelPos>& level = levels[i];
+
+    // Keep all takeoff and landing points
+    if(level.isEmpty() || level.last().trackPos.onGround != trackPos.onGround ||
+       level.last().trackPos.pos.distanceMeterTo(trackPos.pos) >= LEVEL_MIN_DISTANCE_METER.at(i))
+      level.append({trackPos, sequence});
+  }
+}
+
+void AircraftTrack::pruneLevels()
+{
+  for(QList<LevelPos>& level : levels)
+  {
+    while(!level.isEmpty() && level.first().sequence < firstSequence)
+      level.removeFirst();
+  }
+}
+
+void AircraftTrack::rebuildLevels()
+{
+  for(QList<LevelPos>& level : levels)
+    level.clear();
+
+  for(int i = 0; i < numEntries; i++)
+    appendLevels(at(i), firstSequence + i);
+}
+
+void AircraftTrack::setMaxTrackEntries(int value)
+{
+  if(value == maxTrackEntries)
+    return;
+
+  maxTrackEntries = value;
+
+  if(numEntries > 0)
+  {
+    // Copy positions into a new buffer in order and keep only the latest ones
+    QVector<at::AircraftTrackPos> newBuffer;
+    newBuffer.reserve(std::min(numEntries, maxTrackEntries));
+    for(int i = std::max(0, numEntries - maxTrackEntries); i < numEntries; i++)
+      newBuffer.append(at(i));
+
+    buffer.swap(newBuffer);
+    head = 0;
+    numEntries = buffer.size();
+
+    // Pruning could leave levels empty if all their positions were dropped
+    rebuildLevels();
+  }
+}
+
+int AircraftTrack::getLevelForDistance(float distanceMeter) const
+{
+  int level = 0;
+  for(int i = 0; i < LEVEL_MIN_DISTANCE_METER.size(); i++)
+  {
+    if(LEVEL_MIN_DISTANCE_METER.at(i) <= distanceMeter)
+      level = i + 1;
+  }
+  return level;
+}
+
 float AircraftTrack::getMaxAltitude() const
 {
   float maxAlt = 0.f;
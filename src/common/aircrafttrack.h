@@ -20,6 +20,10 @@
 
 #include "geo/pos.h"
 
+#include <QVector>
+
+class QFile;
+
 namespace at {
 /* Track position. Can be converted to QVariant and thus be saved to settings */
 struct AircraftTrackPos
@@ -38,23 +42,71 @@ Q_DECLARE_TYPEINFO(at::AircraftTrackPos, Q_PRIMITIVE_TYPE);
 Q_DECLARE_METATYPE(at::AircraftTrackPos);
 
 /*
- * Stores the track of the flight simulator aircraft
+ * Stores the track of the flight simulator aircraft.
+ *
+ * Positions are kept in a ring buffer which drops the oldest entries in blocks if full.
+ * Additionally a pyramid of simplified tracks is maintained while appending positions. Each level keeps only
+ * positions which are a minimum distance apart. Painters can use a coarser level for smaller zoom factors
+ * instead of iterating over all positions. Level 0 is the full resolution track.
  */
-class AircraftTrack :
-  private QList<at::AircraftTrackPos>
+class AircraftTrack
 {
 public:
   AircraftTrack();
   ~AircraftTrack();
 
-  /* Saves and restores track into a separate file (little_navmap.track) */
+  /* Forward iterator over all positions from oldest to latest */
+  class const_iterator
+  {
+  public:
+    const_iterator(const AircraftTrack *aircraftTrack, int idx)
+      : track(aircraftTrack), index(idx)
+    {
+    }
+
+    const at::AircraftTrackPos& operator*() const
+    {
+      return track->at(index);
+    }
+
+    const at::AircraftTrackPos *operator->() const
+    {
+      return &track->at(index);
+    }
+
+    const_iterator& operator++()
+    {
+      index++;
+      return *this;
+    }
+
+    bool operator==(const const_iterator& other) const
+    {
+      return index == other.index && track == other.track;
+    }
+
+    bool operator!=(const const_iterator& other) const
+    {
+      return !operator==(other);
+    }
+
+  private:
+    const AircraftTrack *track;
+    int index;
+  };
+
+  /*
+   * The track is stored in a journal file (little_navmap.track) which gets each position appended while flying.
+   * Each position is stored with a checksum to detect incomplete writes after a crash.
+   * The file is rewritten only if it contains too many pruned positions or does not match the track.
+   *
+   * saveState closes the journal and restoreState reads only the positions fitting into the ring buffer
+   * from the end of the memory mapped file. Files of the old format are converted on the next write.
+   */
   void saveState();
   void restoreState();
 
-  void clearTrack()
-  {
-    clear();
-  }
+  void clearTrack();
 
   /*
    * Add a track position. Accurracy depends on the ground flag which will cause more
@@ -65,23 +117,102 @@ public:
 
   float getMaxAltitude() const;
 
-  /* Pull only needed methods into public space */
-  using QList::isEmpty;
-  using QList::first;
-  using QList::last;
-  using QList::size;
-  using QList::at;
-  using QList::begin;
-  using QList::end;
+  bool isEmpty() const
+  {
+    return numEntries == 0;
+  }
+
+  int size() const
+  {
+    return numEntries;
+  }
+
+  const at::AircraftTrackPos& at(int index) const
+  {
+    return buffer.at((head + index) % buffer.size());
+  }
+
+  const at::AircraftTrackPos& first() const
+  {
+    return at(0);
+  }
+
+  const at::AircraftTrackPos& last() const
+  {
+    return at(numEntries - 1);
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator(this, 0);
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator(this, numEntries);
+  }
+
+  /* Number of levels including the full resolution track at level 0 */
+  int getNumLevels() const
+  {
+    return levels.size() + 1;
+  }
+
+  /* Get the coarsest level where positions are at most the given distance apart. 0 if none matches. */
+  int getLevelForDistance(float distanceMeter) const;
+
+  /* Number of positions in level. Latest position might be missing in levels > 0. */
+  int getLevelSize(int level) const
+  {
+    return level == 0 ? numEntries : levels.at(level - 1).size();
+  }
 
-  void setMaxTrackEntries(int value)
+  const at::AircraftTrackPos& getLevelPos(int level, int index) const
   {
-    maxTrackEntries = value;
+    return level == 0 ? at(index) : levels.at(level - 1).at(index).trackPos;
   }
 
+  /* Changes the capacity of the ring buffer. Removes oldest positions if needed. */
+  void setMaxTrackEntries(int value);
+
 private:
+  void clearInternal();
+
+  /* Read positions from the memory mapped journal */
+  void readJournal(const uchar *data, qint64 size);
+
+  /* Read all positions from a file in the old QDataStream based format */
+  void readLegacy(QFile& trackFile);
+
+  /* Append position to journal or rewrite the whole journal if needed */
+  void writeJournal(const at::AircraftTrackPos& trackPos);
+
+  /* Write all positions into a new journal which replaces the old one */
+  void compactJournal();
+  void openJournal();
+  void closeJournal();
+  QString journalFilename() const;
+
+  static void encodeRecord(uchar *record, const at::AircraftTrackPos& trackPos);
+
+  /* Returns false if the checksum does not match */
+  static bool decodeRecord(const uchar *record, at::AircraftTrackPos& trackPos);
+
+  /* Add to ring buffer and all levels. Prunes if full and returns true in this case. */
+  bool appendInternal(const at::AircraftTrackPos& trackPos);
+
+  /* Add position to all levels if far enough from the last position of the level */
+  void appendLevels(const at::AircraftTrackPos& trackPos, qint64 sequence);
+
+  /* Remove positions from all levels which were dropped from the ring buffer. Uses the sequence number
+   * since timestamps can go backwards when changing the simulator time. */
+  void pruneLevels();
+
+  /* Build all levels again from the ring buffer */
+  void rebuildLevels();
+
   /* Maximum number of track points. If exceeded entries will be removed from beginning of the list */
-  int maxTrackEntries = 20000;
+  int maxTrackEntries = 100000;
   /* Number of entries to remove at once */
   static Q_DECL_CONSTEXPR int PRUNE_TRACK_ENTRIES = 200;
 
@@ -96,6 +227,40 @@ private:
 
   /* Version 2 to adds timstamp and single floating point precision */
   static Q_DECL_CONSTEXPR quint16 FILE_VERSION = 2;
+
+  /* Version 3 is the journal in little endian byte order.
+   * Header is magic number, version and record size.
+   * Record is longitude, latitude, altitude (float), timestamp (quint32), ground flag (quint8),
+   * one reserved byte and CRC16 checksum (quint16) of the previous bytes. */
+  static Q_DECL_CONSTEXPR quint16 JOURNAL_FILE_VERSION = 3;
+  static Q_DECL_CONSTEXPR int JOURNAL_HEADER_SIZE = 8;
+  static Q_DECL_CONSTEXPR int JOURNAL_RECORD_SIZE = 20;
+
+  /* Ring buffer. Grows up to maxTrackEntries + 1. head is the index of the oldest position. */
+  QVector<at::AircraftTrackPos> buffer;
+  int head = 0, numEntries = 0;
+
+  /* Sequence number of the oldest position in the ring buffer. Increased when pruning. */
+  qint64 firstSequence = 0;
+
+  /* Level position with the sequence number of the position in the ring buffer */
+  struct LevelPos
+  {
+    at::AircraftTrackPos trackPos;
+    qint64 sequence;
+  };
+
+  /* Simplified tracks for level 1 and up */
+  QVector<QList<LevelPos> > levels;
+
+  /* Journal file opened for appending. null if not written yet. */
+  QFile *journalFile = nullptr;
+
+  /* Number of positions in journal */
+  int journalRecords = 0;
+
+  /* true if the last positions in the journal are equal to the track */
+  bool journalSynced = false;
 };
 
 #endif // LITTLENAVMAP_AIRCRAFTTRACK_H
@@ -226,6 +226,23 @@ const QLatin1Literal OPTIONS_VERSION("Options/Version");
 const QLatin1Literal OPTIONS_NO_USER_AGENT("Options/NoUserAgent");
 const QLatin1Literal OPTIONS_WEATHER_UPDATE("Options/WeatherUpdate");
 
+/* Record all simulator data packets into this file if not empty */
+const QLatin1Literal OPTIONS_SIMDATA_RECORD_FILE("Options/SimDataRecordFile");
+
+/* Replay this recorded file instead of connecting to a simulator if not empty */
+const QLatin1Literal OPTIONS_SIMDATA_REPLAY_FILE("Options/SimDataReplayFile");
+
+/* Replay speed factor. 1 is real time and 0 is as fast as possible. */
+const QLatin1Literal OPTIONS_SIMDATA_REPLAY_SPEED("Options/SimDataReplaySpeed");
+
+/* Start a local server sending synthetic traffic on this port if not 0 */
+const QLatin1Literal OPTIONS_SIMDATA_SERVER_PORT("Options/SimDataServerPort");
+const QLatin1Literal OPTIONS_SIMDATA_SERVER_AI_AIRCRAFT("Options/SimDataServerAiAircraft");
+const QLatin1Literal OPTIONS_SIMDATA_SERVER_GROUND_PERCENT("Options/SimDataServerGroundPercent");
+const QLatin1Literal OPTIONS_SIMDATA_SERVER_UPDATE_RATE("Options/SimDataServerUpdateRateMs");
+const QLatin1Literal OPTIONS_SIMDATA_SERVER_LONX("Options/SimDataServerLonX");
+const QLatin1Literal OPTIONS_SIMDATA_SERVER_LATY("Options/SimDataServerLatY");
+
 /* Used to override  default URL */
 const QLatin1Literal OPTIONS_UPDATE_URL("Update/Url");
 
@@ -41,6 +41,7 @@
 #include "common/unit.h"
 #include "fs/weather/metar.h"
 #include "fs/weather/metarparser.h"
+#include "weather/weatherreporter.h"
 #include "common/vehicleicons.h"
 
 #include <QSize>
@@ -315,38 +316,39 @@ void HtmlInfoBuilder::airportText(const MapAirport& airport, const map::WeatherC
       // Simulator weather =====================================================
       QString sim = tr("%1 ").arg(NavApp::getCurrentSimulatorShortName());
       addMetarLine(html, tr("%1Station").arg(sim), fsMetar.metarForStation,
-                   fsMetar.requestIdent, fsMetar.timestamp, true /* fs */, src == WEATHER_SOURCE_SIMULATOR);
+                   fsMetar.requestIdent, fsMetar.timestamp, true /* fs */, WEATHER_SOURCE_SIMULATOR,
+                   src == WEATHER_SOURCE_SIMULATOR);
       addMetarLine(html, tr("%1Nearest").arg(sim),
                    fsMetar.metarForNearest, fsMetar.requestIdent, fsMetar.timestamp,
-                   true /* fs */, src == WEATHER_SOURCE_SIMULATOR);
+                   true /* fs */, WEATHER_SOURCE_SIMULATOR, src == WEATHER_SOURCE_SIMULATOR);
       addMetarLine(html, tr("%1Interpolated").arg(sim),
                    fsMetar.metarForInterpolated, fsMetar.requestIdent, fsMetar.timestamp,
-                   true /* fs */, src == WEATHER_SOURCE_SIMULATOR);
+                   true /* fs */, WEATHER_SOURCE_SIMULATOR, src == WEATHER_SOURCE_SIMULATOR);
     }
 
     // Active Sky weather =====================================================
     addMetarLine(html, weatherContext.asType, weatherContext.asMetar, QString(), QDateTime(),
-                 false /* fs */, src == WEATHER_SOURCE_ACTIVE_SKY);
+                 false /* fs */, WEATHER_SOURCE_ACTIVE_SKY, src == WEATHER_SOURCE_ACTIVE_SKY);
 
     // NOAA weather =====================================================
     addMetarLine(html, tr("NOAA Station"), weatherContext.noaaMetar.metarForStation,
                  weatherContext.noaaMetar.requestIdent, weatherContext.noaaMetar.timestamp,
-                 false /* fs */, src == WEATHER_SOURCE_NOAA);
+                 false /* fs */, WEATHER_SOURCE_NOAA, src == WEATHER_SOURCE_NOAA);
     addMetarLine(html, tr("NOAA Nearest"), weatherContext.noaaMetar.metarForNearest,
                  weatherContext.noaaMetar.requestIdent, weatherContext.noaaMetar.timestamp,
-                 false /* fs */, src == WEATHER_SOURCE_NOAA);
+                 false /* fs */, WEATHER_SOURCE_NOAA, src == WEATHER_SOURCE_NOAA);
 
     // VATSIM weather =====================================================
     addMetarLine(html, tr("VATSIM"), weatherContext.vatsimMetar, QString(), QDateTime(),
-                 false /* fs */, src == WEATHER_SOURCE_VATSIM);
+                 false /* fs */, WEATHER_SOURCE_VATSIM, src == WEATHER_SOURCE_VATSIM);
 
     // IVAO weather =====================================================
     addMetarLine(html, tr("IVAO Station"), weatherContext.ivaoMetar.metarForStation,
                  weatherContext.ivaoMetar.requestIdent, weatherContext.ivaoMetar.timestamp,
-                 false /* fs */, src == WEATHER_SOURCE_IVAO);
+                 false /* fs */, WEATHER_SOURCE_IVAO, src == WEATHER_SOURCE_IVAO);
     addMetarLine(html, tr("IVAO Nearest"), weatherContext.ivaoMetar.metarForNearest,
                  weatherContext.ivaoMetar.requestIdent, weatherContext.ivaoMetar.timestamp,
-                 false /* fs */, src == WEATHER_SOURCE_IVAO);
+                 false /* fs */, WEATHER_SOURCE_IVAO, src == WEATHER_SOURCE_IVAO);
     html.tableEnd();
   }
 
@@ -1116,7 +1118,8 @@ void HtmlInfoBuilder::weatherText(const map::WeatherContext& context, const MapA
 
       if(!metar.metarForStation.isEmpty())
       {
-        Metar met(metar.metarForStation, metar.requestIdent, metar.timestamp, true);
+        const Metar& met = NavApp::getWeatherReporter()->getParsedMetar(metar.requestIdent, WEATHER_SOURCE_SIMULATOR,
+                                                                        metar.metarForStation, metar.timestamp, true);
 
         html.p(tr("%1Station Weather").arg(sim), WEATHER_TITLE_FLAGS);
         decodedMetar(html, airport, map::MapAirport(), met, false /* interpolated */, fsxP3d,
@@ -1125,7 +1128,8 @@ void HtmlInfoBuilder::weatherText(const map::WeatherContext& context, const MapA
 
       if(!metar.metarForNearest.isEmpty())
       {
-        Metar met(metar.metarForNearest, metar.requestIdent, metar.timestamp, true);
+        const Metar& met = NavApp::getWeatherReporter()->getParsedMetar(metar.requestIdent, WEATHER_SOURCE_SIMULATOR,
+                                                                        metar.metarForNearest, metar.timestamp, true);
         QString reportIcao = met.getParsedMetar().isValid() ? met.getParsedMetar().getId() : met.getStation();
 
         html.p(tr("%2Nearest Weather - %1").arg(reportIcao).arg(sim), WEATHER_TITLE_FLAGS);
@@ -1147,7 +1151,9 @@ void HtmlInfoBuilder::weatherText(const map::WeatherContext& context, const MapA
 
       if(!metar.metarForInterpolated.isEmpty())
       {
-        Metar met(metar.metarForInterpolated, metar.requestIdent, metar.timestamp, fsxP3d);
+        const Metar& met = NavApp::getWeatherReporter()->getParsedMetar(metar.requestIdent, WEATHER_SOURCE_SIMULATOR,
+                                                                        metar.metarForInterpolated, metar.timestamp,
+                                                                        fsxP3d);
         html.p(tr("%2Interpolated Weather - %1").arg(met.getStation()).arg(sim), WEATHER_TITLE_FLAGS);
         decodedMetar(html, airport, map::MapAirport(), met, true /* interpolated */, fsxP3d, false /* map src */);
       }
@@ -1167,41 +1173,50 @@ void HtmlInfoBuilder::weatherText(const map::WeatherContext& context, const MapA
       else
         html.p(context.asType, WEATHER_TITLE_FLAGS);
 
-      decodedMetar(html, airport, map::MapAirport(), Metar(context.asMetar), false /* interpolated */,
+      decodedMetar(html, airport, map::MapAirport(),
+                   NavApp::getWeatherReporter()->getParsedMetar(QString(), WEATHER_SOURCE_ACTIVE_SKY,
+                                                                context.asMetar), false /* interpolated */,
                    false /* FSX/P3D */, src == WEATHER_SOURCE_ACTIVE_SKY);
     }
 
     // NOAA or nearest
-    decodedMetars(html, context.noaaMetar, airport, tr("NOAA"), src == WEATHER_SOURCE_NOAA);
+    decodedMetars(html, context.noaaMetar, airport, tr("NOAA"), WEATHER_SOURCE_NOAA, src == WEATHER_SOURCE_NOAA);
 
     // Vatsim metar ===========================
     if(!context.vatsimMetar.isEmpty())
     {
       html.p(tr("VATSIM Weather"), WEATHER_TITLE_FLAGS);
-      decodedMetar(html, airport, map::MapAirport(), Metar(context.vatsimMetar),
+      decodedMetar(html, airport, map::MapAirport(),
+                   NavApp::getWeatherReporter()->getParsedMetar(QString(), WEATHER_SOURCE_VATSIM,
+                                                                context.vatsimMetar),
                    false /* interpolated */, false /* FSX/P3D */, src == WEATHER_SOURCE_VATSIM);
     }
 
     // IVAO or nearest
-    decodedMetars(html, context.ivaoMetar, airport, tr("IVAO"), src == WEATHER_SOURCE_IVAO);
+    decodedMetars(html, context.ivaoMetar, airport, tr("IVAO"), WEATHER_SOURCE_IVAO, src == WEATHER_SOURCE_IVAO);
   }
 }
 
 void HtmlInfoBuilder::decodedMetars(HtmlBuilder& html, const atools::fs::weather::MetarResult& metar,
-                                    const map::MapAirport& airport, const QString& name, bool mapDisplay) const
+                                    const map::MapAirport& airport, const QString& name,
+                                    map::MapWeatherSource source, bool mapDisplay) const
 {
+  WeatherReporter *weatherReporter = NavApp::getWeatherReporter();
+
   if(metar.isValid())
   {
     if(!metar.metarForStation.isEmpty())
     {
       html.p(tr("%1 Station Weather").arg(name), WEATHER_TITLE_FLAGS);
       decodedMetar(html, airport, map::MapAirport(),
-                   Metar(metar.metarForStation, metar.requestIdent, metar.timestamp, true), false, false, mapDisplay);
+                   weatherReporter->getParsedMetar(metar.requestIdent, source, metar.metarForStation,
+                                                   metar.timestamp, true), false, false, mapDisplay);
     }
 
     if(!metar.metarForNearest.isEmpty())
     {
-      Metar met(metar.metarForNearest, metar.requestIdent, metar.timestamp, true);
+      const Metar& met = weatherReporter->getParsedMetar(metar.requestIdent, source, metar.metarForNearest,
+                                                         metar.timestamp, true);
       QString reportIcao = met.getParsedMetar().isValid() ? met.getParsedMetar().getId() : met.getStation();
 
       html.p(tr("%1 Nearest Weather - %2").arg(name).arg(reportIcao), WEATHER_TITLE_FLAGS);
@@ -3149,11 +3164,12 @@ void HtmlInfoBuilder::rowForStrCap(HtmlBuilder& html, const SqlRecord *rec, cons
 
 void HtmlInfoBuilder::addMetarLine(atools::util::HtmlBuilder& html, const QString& heading,
                                    const QString& metar, const QString& station,
-                                   const QDateTime& timestamp, bool fsMetar, bool mapDisplay) const
+                                   const QDateTime& timestamp, bool fsMetar, map::MapWeatherSource source,
+                                   bool mapDisplay) const
 {
   if(!metar.isEmpty())
   {
-    Metar m(metar, station, timestamp, fsMetar);
+    const Metar& m = NavApp::getWeatherReporter()->getParsedMetar(station, source, metar, timestamp, fsMetar);
     const atools::fs::weather::MetarParser& pm = m.getParsedMetar();
 
     if(!pm.isValid())
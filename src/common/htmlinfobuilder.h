@@ -316,13 +316,15 @@ private:
                    atools::util::HtmlBuilder& html) const;
   void addMetarLine(atools::util::HtmlBuilder& html, const QString& heading, const QString& metar,
                     const QString& station,
-                    const QDateTime& timestamp, bool fsMetar, bool mapDisplay) const;
+                    const QDateTime& timestamp, bool fsMetar, map::MapWeatherSource source,
+                    bool mapDisplay) const;
 
   void decodedMetar(atools::util::HtmlBuilder& html, const map::MapAirport& airport,
                     const map::MapAirport& reportAirport, const atools::fs::weather::Metar& metar,
                     bool isInterpolated, bool isFsxP3d, bool mapDisplay) const;
   void decodedMetars(atools::util::HtmlBuilder& html, const atools::fs::weather::MetarResult& metar,
-                     const map::MapAirport& airport, const QString& name, bool mapDisplay) const;
+                     const map::MapAirport& airport, const QString& name, map::MapWeatherSource source,
+                     bool mapDisplay) const;
 
   bool buildWeatherContext(map::WeatherContext& lastContext, map::WeatherContext& newContext,
                            const map::MapAirport& airport);
@@ -0,0 +1,303 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "common/paintstatistics.h"
+
+#include "settings/settings.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QMutexLocker>
+#include <QTextStream>
+
+#include <atomic>
+
+namespace pstats {
+
+/* Rotate log file if larger than this */
+const static qint64 MAX_LOG_FILE_SIZE = 10 * 1024 * 1024;
+
+/* Write buffered lines to the log file not more often than this */
+const static qint64 LOG_FLUSH_INTERVAL_MS = 2000L;
+
+struct Value
+{
+  QString name;
+  qint64 nsecs;
+  int count; /* Objects for painters and misses for caches */
+};
+
+static std::atomic_bool enabled(false);
+static QMutex mutex;
+
+/* Values of the current and last frame */
+static QVector<Value> painters, lastPainters, caches, lastCaches;
+static qint64 lastFrameNsecs = 0L;
+static int lastObjectCount = 0;
+static QElapsedTimer frameTimer;
+
+/* Simulator data totals since enabling and last parse time */
+static qint64 simDataPackets = 0L, simDataDropped = 0L, lastSimDataParseNsecs = 0L;
+
+static QFile *logFile = nullptr;
+static QTextStream *logStream = nullptr;
+static QElapsedTimer flushTimer;
+
+static void closeLog()
+{
+  if(logStream != nullptr)
+  {
+    logStream->flush();
+    delete logStream;
+    logStream = nullptr;
+  }
+
+  if(logFile != nullptr)
+  {
+    logFile->close();
+    delete logFile;
+    logFile = nullptr;
+  }
+}
+
+static void openLog()
+{
+  closeLog();
+
+  logFile = new QFile(atools::settings::Settings::getConfigFilename("_paint.csv"));
+
+  if(logFile->size() > MAX_LOG_FILE_SIZE)
+  {
+    // Keep one old file
+    QString oldName = logFile->fileName() + ".1";
+    QFile::remove(oldName);
+    logFile->rename(oldName);
+    logFile->setFileName(atools::settings::Settings::getConfigFilename("_paint.csv"));
+  }
+
+  bool writeHeader = !logFile->exists() || logFile->size() == 0;
+
+  if(logFile->open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+  {
+    qDebug() << Q_FUNC_INFO << "Writing paint statistics to" << logFile->fileName();
+
+    logStream = new QTextStream(logFile);
+    logStream->setCodec("UTF-8");
+    if(writeHeader)
+      *logStream << "time,type,name,ms,count\n";
+    flushTimer.start();
+  }
+  else
+  {
+    qWarning() << "Cannot open paint statistics" << logFile->fileName() << ":" << logFile->errorString();
+    delete logFile;
+    logFile = nullptr;
+  }
+}
+
+/* Flush the log file if the interval has passed since the last flush */
+static void flushLogDelayed()
+{
+  if(logStream != nullptr && flushTimer.hasExpired(LOG_FLUSH_INTERVAL_MS))
+  {
+    logStream->flush();
+    flushTimer.start();
+  }
+}
+
+/* Sum up values with the same name */
+static void addValue(QVector<Value>& values, const char *name, qint64 nsecs, int count)
+{
+  QString str(name);
+  for(Value& value : values)
+  {
+    if(value.name == str)
+    {
+      value.nsecs += nsecs;
+      value.count += count;
+      return;
+    }
+  }
+  values.append({str, nsecs, count});
+}
+
+static QString toMs(qint64 nsecs)
+{
+  return QString::number(static_cast<double>(nsecs) / 1000000., 'f', 2);
+}
+
+void setEnabled(bool enable)
+{
+  if(enable != enabled)
+  {
+    QMutexLocker locker(&mutex);
+    enabled = enable;
+
+    painters.clear();
+    lastPainters.clear();
+    caches.clear();
+    lastCaches.clear();
+    lastFrameNsecs = 0L;
+    lastObjectCount = 0;
+    simDataPackets = simDataDropped = lastSimDataParseNsecs = 0L;
+
+    if(enable)
+      openLog();
+    else
+      closeLog();
+  }
+}
+
+bool isEnabled()
+{
+  return enabled;
+}
+
+void beginFrame()
+{
+  if(enabled)
+    frameTimer.start();
+}
+
+void endFrame(int objectCount)
+{
+  if(!enabled || !frameTimer.isValid())
+    return;
+
+  QMutexLocker locker(&mutex);
+  lastFrameNsecs = frameTimer.nsecsElapsed();
+  lastObjectCount = objectCount;
+  lastPainters.swap(painters);
+  lastCaches.swap(caches);
+  painters.clear();
+  caches.clear();
+  frameTimer.invalidate();
+
+  if(logStream != nullptr)
+  {
+    QString time = QDateTime::currentDateTime().toString("yyyy-MM-dd'T'HH:mm:ss.zzz");
+    QTextStream& out = *logStream;
+    out << time << ",frame,," << toMs(lastFrameNsecs) << "," << lastObjectCount << "\n";
+
+    for(const Value& value : lastPainters)
+      out << time << ",painter," << value.name << "," << toMs(value.nsecs) << "," << value.count << "\n";
+
+    for(const Value& value : lastCaches)
+      out << time << ",cache," << value.name << "," << toMs(value.nsecs) << "," << value.count << "\n";
+
+    flushLogDelayed();
+
+    if(logFile->size() > MAX_LOG_FILE_SIZE)
+      // Rotate file
+      openLog();
+  }
+}
+
+void addPainter(const char *name, qint64 nsecs, int objects)
+{
+  if(enabled)
+  {
+    QMutexLocker locker(&mutex);
+    addValue(painters, name, nsecs, objects);
+  }
+}
+
+void addCacheMiss(const char *name, qint64 nsecs)
+{
+  if(enabled)
+  {
+    QMutexLocker locker(&mutex);
+    addValue(caches, name, nsecs, 1);
+  }
+}
+
+void addSimData(qint64 parseNsecs, int packets, int dropped)
+{
+  if(enabled)
+  {
+    QMutexLocker locker(&mutex);
+    simDataPackets += packets;
+    simDataDropped += dropped;
+    lastSimDataParseNsecs = parseNsecs;
+
+    if(logStream != nullptr)
+    {
+      QString time = QDateTime::currentDateTime().toString("yyyy-MM-dd'T'HH:mm:ss.zzz");
+      *logStream << time << ",simdata,parsed," << toMs(parseNsecs) << "," << packets << "\n";
+      if(dropped > 0)
+        *logStream << time << ",simdata,dropped,," << dropped << "\n";
+
+      flushLogDelayed();
+    }
+  }
+}
+
+QStringList overlayText()
+{
+  QStringList text;
+  if(enabled)
+  {
+    QMutexLocker locker(&mutex);
+
+    text.append(QString("Frame %1 ms, %2 objects").arg(toMs(lastFrameNsecs)).arg(lastObjectCount));
+
+    for(const Value& value : lastPainters)
+      text.append(QString("%1 %2 ms, %3 objects").arg(value.name).arg(toMs(value.nsecs)).arg(value.count));
+
+    if(lastCaches.isEmpty())
+      text.append("No cache misses");
+    else
+    {
+      for(const Value& value : lastCaches)
+        text.append(QString("Cache %1 %2 ms, %3 misses").arg(value.name).arg(toMs(value.nsecs)).arg(value.count));
+    }
+
+    if(simDataPackets > 0)
+      text.append(QString("Sim data %1 packets, %2 dropped, last parse %3 ms").
+                  arg(simDataPackets).arg(simDataDropped).arg(toMs(lastSimDataParseNsecs)));
+  }
+  return text;
+}
+
+// =================================================================================
+ScopedTimer::ScopedTimer(const char *painterName, const int& objectCountRef)
+  : name(painterName), objectCount(&objectCountRef), objectCountStart(objectCountRef), active(enabled)
+{
+  if(active)
+    timer.start();
+}
+
+ScopedTimer::ScopedTimer(const char *cacheName)
+  : name(cacheName), objectCount(nullptr), active(enabled)
+{
+  if(active)
+    timer.start();
+}
+
+ScopedTimer::~ScopedTimer()
+{
+  if(active)
+  {
+    if(objectCount != nullptr)
+      addPainter(name, timer.nsecsElapsed(), *objectCount - objectCountStart);
+    else
+      addCacheMiss(name, timer.nsecsElapsed());
+  }
+}
+
+} // namespace pstats
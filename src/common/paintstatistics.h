@@ -0,0 +1,85 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_COMMON_PAINTSTATISTICS_H
+#define LNM_COMMON_PAINTSTATISTICS_H
+
+#include <QElapsedTimer>
+#include <QStringList>
+
+/*
+ * Collects frame times, time per painter, number of drawn objects and cache misses of the query classes
+ * for each map paint event. Also counts simulator data packets read from the network and outdated packets
+ * which were dropped.
+ *
+ * Values of the last frame can be shown on the map. All values are also appended to a CSV file
+ * (little_navmap_paint.csv) in the settings directory which is rotated once it gets too large.
+ *
+ * Collecting is disabled by default and costs only a flag check then.
+ * Functions adding values are thread safe.
+ */
+namespace pstats {
+
+/* Enable or disable collecting. Opens or closes the log file. Lines are buffered and written every few seconds
+ * or when closing. */
+void setEnabled(bool enable);
+bool isEnabled();
+
+/* Call at start and end of each map paint event. objectCount is the total number of drawn objects. */
+void beginFrame();
+void endFrame(int objectCount);
+
+/* Add painting time for a painter */
+void addPainter(const char *name, qint64 nsecs, int objects);
+
+/* Add a cache miss and the time needed to fill the cache */
+void addCacheMiss(const char *name, qint64 nsecs);
+
+/* Add time needed to parse packets from the network connection. dropped is the number of outdated packets
+ * which were not sent around because a newer one was read in the same call. */
+void addSimData(qint64 parseNsecs, int packets, int dropped);
+
+/* Text lines describing the last frame for the map overlay */
+QStringList overlayText();
+
+/*
+ * Measures time between construction and destruction and adds it to the statistics.
+ * Does nothing if collecting is disabled.
+ */
+class ScopedTimer
+{
+public:
+  /* Time for a painter. The number of drawn objects is the difference of objectCount between
+   * construction and destruction. */
+  ScopedTimer(const char *painterName, const int& objectCountRef);
+
+  /* Time for a cache miss */
+  explicit ScopedTimer(const char *cacheName);
+
+  ~ScopedTimer();
+
+private:
+  const char *name;
+  const int *objectCount;
+  int objectCountStart = 0;
+  bool active;
+  QElapsedTimer timer;
+};
+
+} // namespace pstats
+
+#endif // LNM_COMMON_PAINTSTATISTICS_H
@@ -17,6 +17,11 @@
 
 #include "connect/connectclient.h"
 
+#include "connect/simdatarecorder.h"
+#include "connect/simdatareplay.h"
+#include "connect/simdatadispatcher.h"
+#include "connect/simdataserver.h"
+#include "common/paintstatistics.h"
 #include "navapp.h"
 #include "common/constants.h"
 #include "fs/sc/simconnectreply.h"
@@ -31,6 +36,8 @@
 #include "fs/sc/xpconnecthandler.h"
 
 #include <QDataStream>
+#include <QElapsedTimer>
+#include <QFileInfo>
 #include <QTcpSocket>
 #include <QWidget>
 #include <QApplication>
@@ -77,12 +84,72 @@ ConnectClient::ConnectClient(MainWindow *parent)
   connect(dialog, &ConnectDialog::disconnectClicked, this, &ConnectClient::disconnectClicked);
   connect(dialog, &ConnectDialog::autoConnectToggled, this, &ConnectClient::autoConnectToggled);
 
+  // Connect first to drop any pending packets before the consumers get the disconnect signal
+  dispatcher = new SimDataDispatcher(this);
+  connect(this, &ConnectClient::dataPacketReceived, dispatcher, &SimDataDispatcher::dispatch);
+  connect(this, &ConnectClient::connectedToSimulator, dispatcher, &SimDataDispatcher::clear);
+  connect(this, &ConnectClient::disconnectedFromSimulator, dispatcher, &SimDataDispatcher::clear);
+
+  // Recording and replay of simulator data for testing and profiling without simulator
+  replayFilename = settings.getAndStoreValue(lnm::OPTIONS_SIMDATA_REPLAY_FILE, QString()).toString();
+  replaySpeed = settings.getAndStoreValue(lnm::OPTIONS_SIMDATA_REPLAY_SPEED, 1.f).toFloat();
+
+  QString recordFilename = settings.getAndStoreValue(lnm::OPTIONS_SIMDATA_RECORD_FILE, QString()).toString();
+  if(!recordFilename.isEmpty())
+  {
+    QFileInfo recordInfo(recordFilename), replayInfo(replayFilename);
+    if(!replayFilename.isEmpty() &&
+       (recordInfo.absoluteFilePath() == replayInfo.absoluteFilePath() ||
+        (recordInfo.exists() && recordInfo.canonicalFilePath() == replayInfo.canonicalFilePath())))
+      // Opening the recorder would truncate the file before it is replayed
+      qWarning() << "Cannot record simulator data to replay file" << recordFilename;
+    else
+    {
+      recorder = new SimDataRecorder(recordFilename);
+      if(!recorder->open())
+      {
+        delete recorder;
+        recorder = nullptr;
+      }
+    }
+  }
+
+  // Synthetic traffic for load tests. Connect to localhost using the connect dialog.
+  int serverPort = settings.getAndStoreValue(lnm::OPTIONS_SIMDATA_SERVER_PORT, 0).toInt();
+  if(serverPort > 0)
+  {
+    atools::geo::Pos center(settings.getAndStoreValue(lnm::OPTIONS_SIMDATA_SERVER_LONX, 8.57f).toFloat(),
+                            settings.getAndStoreValue(lnm::OPTIONS_SIMDATA_SERVER_LATY, 50.03f).toFloat());
+    server = new SimDataServer(static_cast<quint16>(serverPort), center,
+                               settings.getAndStoreValue(lnm::OPTIONS_SIMDATA_SERVER_AI_AIRCRAFT, 500).toInt(),
+                               settings.getAndStoreValue(lnm::OPTIONS_SIMDATA_SERVER_GROUND_PERCENT, 30).toInt(),
+                               settings.getAndStoreValue(lnm::OPTIONS_SIMDATA_SERVER_UPDATE_RATE, 500).toInt());
+
+    // Generate and send packets in an own thread to avoid loading the GUI thread which is measured
+    serverThread = new QThread(this);
+    serverThread->setObjectName("SimDataServer");
+    server->moveToThread(serverThread);
+    connect(serverThread, &QThread::started, server, &SimDataServer::start);
+    connect(serverThread, &QThread::finished, server, &QObject::deleteLater);
+    serverThread->start();
+  }
+
   reconnectNetworkTimer.setSingleShot(true);
   connect(&reconnectNetworkTimer, &QTimer::timeout, this, &ConnectClient::connectInternal);
 
   flushQueuedRequestsTimer.setInterval(FLUSH_QUEUE_MS);
   connect(&flushQueuedRequestsTimer, &QTimer::timeout, this, &ConnectClient::flushQueuedRequests);
   flushQueuedRequestsTimer.start();
+
+  // Collects all requests of a paint event or similar and sends them once back in the event loop
+  batchRequestsTimer.setSingleShot(true);
+  batchRequestsTimer.setInterval(0);
+  connect(&batchRequestsTimer, &QTimer::timeout, this, &ConnectClient::flushQueuedRequests);
+
+  // Sends one update for a batch of weather replies
+  weatherUpdateTimer.setSingleShot(true);
+  weatherUpdateTimer.setInterval(WEATHER_UPDATE_BATCH_MS);
+  connect(&weatherUpdateTimer, &QTimer::timeout, this, &ConnectClient::emitWeatherUpdated);
 }
 
 ConnectClient::~ConnectClient()
@@ -90,10 +157,24 @@ ConnectClient::~ConnectClient()
   qDebug() << Q_FUNC_INFO;
 
   flushQueuedRequestsTimer.stop();
+  batchRequestsTimer.stop();
+  weatherUpdateTimer.stop();
   reconnectNetworkTimer.stop();
 
   disconnectClicked();
 
+  qDebug() << Q_FUNC_INFO << "delete recorder";
+  delete recorder;
+
+  if(serverThread != nullptr)
+  {
+    // Server is deleted in its thread when finished
+    qDebug() << Q_FUNC_INFO << "stop serverThread";
+    serverThread->quit();
+    serverThread->wait();
+    server = nullptr;
+  }
+
   qDebug() << Q_FUNC_INFO << "delete dataReader";
   delete dataReader;
 
@@ -107,13 +188,26 @@ ConnectClient::~ConnectClient()
   delete dialog;
 }
 
+/* Sends the next queued weather request. The protocol allows only one station per request.
+ * The next one is sent when the reply arrives or on the next timer event. */
 void ConnectClient::flushQueuedRequests()
 {
-  if(!queuedRequests.isEmpty())
+  if(!queuedRequests.isEmpty() && outstandingReplies.isEmpty())
   {
+    // Latest requests first
     atools::fs::sc::WeatherRequest req = queuedRequests.takeLast();
     queuedRequestIdents.remove(req.getStation());
-    requestWeather(req.getStation(), req.getPosition(), false /* station only */);
+    requestWeather(req);
+  }
+}
+
+void ConnectClient::emitWeatherUpdated()
+{
+  weatherUpdateTimer.stop();
+  if(weatherChanged)
+  {
+    weatherChanged = false;
+    emit weatherUpdated();
   }
 }
 
@@ -141,7 +235,7 @@ void ConnectClient::connectToServerDialog()
 
 void ConnectClient::tryConnectOnStartup()
 {
-  if(dialog->isAutoConnect())
+  if(dialog->isAutoConnect() || !replayFilename.isEmpty())
   {
     reconnectNetworkTimer.stop();
 
@@ -201,6 +295,8 @@ void ConnectClient::disconnectedFromSimulatorDirect()
   outstandingReplies.clear();
   queuedRequests.clear();
   queuedRequestIdents.clear();
+  weatherUpdateTimer.stop();
+  weatherChanged = false;
   notAvailableStations.clear();
 
   if(!NavApp::isShuttingDown())
@@ -215,6 +311,10 @@ void ConnectClient::disconnectedFromSimulatorDirect()
 /* Posts data received directly from simconnect or the socket and caches any metar reports */
 void ConnectClient::postSimConnectData(atools::fs::sc::SimConnectData dataPacket)
 {
+  if(recorder != nullptr && replay == nullptr)
+    // Save unmodified packet - but not replayed ones
+    recorder->record(dataPacket);
+
   // Modify AI aircraft and set shadow flag if a online network with the same callsign exists
   for(atools::fs::sc::SimConnectAircraft& aircraft : dataPacket.getAiAircraft())
   {
@@ -227,14 +327,18 @@ void ConnectClient::postSimConnectData(atools::fs::sc::SimConnectData dataPacket
   if(NavApp::getOnlinedataController()->isShadowAircraft(userAircraft))
     userAircraft.setFlags(atools::fs::sc::SIM_ONLINE_SHADOW | userAircraft.getFlags());
 
-  emit dataPacketReceived(dataPacket);
+  // Move packet into a shared snapshot which is passed to all receivers without copying
+  SimConnectDataPtr snapshot = simdata::createSnapshot(std::move(dataPacket));
+  emit dataPacketReceived(snapshot);
+
+  const QVector<atools::fs::weather::MetarResult>& metars = snapshot->getMetars();
 
-  if(!dataPacket.getMetars().isEmpty())
+  if(!metars.isEmpty())
   {
     if(verbose)
-      qDebug() << "Metars number" << dataPacket.getMetars().size();
+      qDebug() << "Metars number" << metars.size();
 
-    for(atools::fs::weather::MetarResult metar : dataPacket.getMetars())
+    for(atools::fs::weather::MetarResult metar : metars)
     {
       QString ident = metar.requestIdent;
       if(verbose)
@@ -262,8 +366,18 @@ void ConnectClient::postSimConnectData(atools::fs::sc::SimConnectData dataPacket
       metarIdentCache.insert(ident, metar);
     }
 
-    if(!dataPacket.getMetars().isEmpty())
-      emit weatherUpdated();
+    // Send the next request with the next event loop iteration instead of waiting for the timer.
+    // Not sent directly since a write error closes the socket while the caller is still reading from it.
+    if(outstandingReplies.isEmpty() && !queuedRequests.isEmpty() && !batchRequestsTimer.isActive())
+      batchRequestsTimer.start();
+
+    // Send a single update once all requests of a batch are answered or
+    // after a short time for long batches to show progress
+    weatherChanged = true;
+    if(queuedRequests.isEmpty() && outstandingReplies.isEmpty())
+      emitWeatherUpdated();
+    else if(!weatherUpdateTimer.isActive())
+      weatherUpdateTimer.start();
   }
 }
 
@@ -348,8 +462,8 @@ atools::fs::weather::MetarResult ConnectClient::requestWeather(const QString& st
     // Return old result if there is any
     retval = *result;
 
-  // Check if the airport is already in the queue
-  if(!queuedRequestIdents.contains(station))
+  // Check if the airport is already in the queue or waiting for a reply
+  if(!queuedRequestIdents.contains(station) && !outstandingReplies.contains(station))
   {
     // Check if it is cached already or timed out
     if(!metarIdentCache.containsNoTimeout(station) || metarIdentCache.isTimedOut(station))
@@ -363,15 +477,12 @@ atools::fs::weather::MetarResult ConnectClient::requestWeather(const QString& st
         weatherRequest.setStation(station);
         weatherRequest.setPosition(pos);
 
-        if(outstandingReplies.isEmpty())
-          // Nothing waiting for reply - request now from network or data reader from sim
-          requestWeather(weatherRequest);
-        else if(!outstandingReplies.contains(weatherRequest.getStation()))
-        {
-          // Not an outstanding reply for this airport - queue request
-          queuedRequests.append(weatherRequest);
-          queuedRequestIdents.insert(station);
-        }
+        // Collect all missing stations and send them when back in the event loop
+        queuedRequests.append(weatherRequest);
+        queuedRequestIdents.insert(station);
+
+        if(!batchRequestsTimer.isActive())
+          batchRequestsTimer.start();
 
         if(verbose)
         {
@@ -440,13 +551,81 @@ void ConnectClient::disconnectClicked()
 
   dataReader->terminateThread();
 
+  stopReplay();
+
   // Close but do not allow reconnect if auto is on
   closeSocket(false);
 }
 
+void ConnectClient::startReplay()
+{
+  stopReplay();
+
+  replay = new SimDataReplay(replayFilename, replaySpeed, this);
+  connect(replay, &SimDataReplay::postSimConnectData, this, &ConnectClient::postSimConnectData);
+  connect(replay, &SimDataReplay::replayFinished, this, &ConnectClient::replayFinished);
+
+  if(replay->start())
+  {
+    mainWindow->setConnectionStatusMessageText(tr("Connected (Replay)"),
+                                               tr("Replaying recorded simulator data from \"%1\".").
+                                               arg(replayFilename));
+    dialog->setConnected(isConnected());
+    emit connectedToSimulator();
+    emit weatherUpdated();
+  }
+  else
+  {
+    mainWindow->setConnectionStatusMessageText(tr("Replay Error"),
+                                               tr("Cannot replay recorded simulator data from \"%1\".").
+                                               arg(replayFilename));
+    replay->deleteLater();
+    replay = nullptr;
+  }
+}
+
+void ConnectClient::stopReplay()
+{
+  if(replay != nullptr)
+  {
+    replay->stop();
+    replayFinished();
+  }
+}
+
+/* Called by signal SimDataReplay::replayFinished or when stopping manually */
+void ConnectClient::replayFinished()
+{
+  if(replay == nullptr)
+    return;
+
+  qDebug() << Q_FUNC_INFO;
+
+  // Might be called from a signal of replay
+  replay->deleteLater();
+  replay = nullptr;
+
+  mainWindow->setConnectionStatusMessageText(tr("Disconnected"), tr("Replay of recorded simulator data finished."));
+  dialog->setConnected(isConnected());
+
+  metarIdentCache.clear();
+  notAvailableStations.clear();
+
+  if(!NavApp::isShuttingDown())
+  {
+    emit disconnectedFromSimulator();
+    emit weatherUpdated();
+  }
+}
+
 void ConnectClient::connectInternal()
 {
-  if(dialog->isAnyConnectDirect())
+  if(!replayFilename.isEmpty())
+  {
+    qDebug() << "Starting replay";
+    startReplay();
+  }
+  else if(dialog->isAnyConnectDirect())
   {
     qDebug() << "Starting direct connection";
     // Datareader has its own reconnect mechanism
@@ -485,6 +664,9 @@ void ConnectClient::connectInternal()
 
 bool ConnectClient::isConnected() const
 {
+  if(replay != nullptr && replay->isActive())
+    return true;
+
   if(dataReader != nullptr)
     return (socket != nullptr && socket->isOpen()) || dataReader->isConnected();
   else
@@ -581,6 +763,8 @@ void ConnectClient::closeSocket(bool allowRestart)
   outstandingReplies.clear();
   queuedRequests.clear();
   queuedRequestIdents.clear();
+  weatherUpdateTimer.stop();
+  weatherChanged = false;
   notAvailableStations.clear();
 
   if(socketConnected)
@@ -646,71 +830,123 @@ void ConnectClient::connectedToServerSocket()
   emit weatherUpdated();
 }
 
-/* Called by signal QTcpSocket::readyRead - read data from socket */
+/* Called by signal QTcpSocket::readyRead - read data from socket.
+ * Reads all complete packets but sends only the newest position packet around. Older ones are outdated
+ * if the application could not keep up and are dropped after replying to the server. */
 void ConnectClient::readFromSocket()
 {
-  if(socket != nullptr)
+  if(socket == nullptr)
+    return;
+
+  // Newest complete packet containing aircraft
+  atools::fs::sc::SimConnectData *newestData = nullptr;
+  int numPackets = 0, numDropped = 0;
+  QElapsedTimer parseTimer;
+  qint64 parseNsecs = 0L;
+
+  while(socket->bytesAvailable())
   {
-    while(socket->bytesAvailable())
-    {
-      if(verbose)
-        qDebug() << "readFromSocket" << socket->bytesAvailable();
-      if(simConnectData == nullptr)
-        // Need to keep the data in background since this method can be called multiple times until the data is filled
-        simConnectData = new atools::fs::sc::SimConnectData;
+    if(verbose)
+      qDebug() << "readFromSocket" << socket->bytesAvailable();
+    if(simConnectData == nullptr)
+      // Need to keep the data in background since this method can be called multiple times until the data is filled
+      simConnectData = new atools::fs::sc::SimConnectData;
 
-      bool read = simConnectData->read(socket);
-      if(simConnectData->getStatus() != atools::fs::sc::OK)
-      {
-        // Something went wrong - shutdown
-        QMessageBox::critical(mainWindow, QApplication::applicationName(),
-                              QString(tr("Error reading data from Little Navconnect: %1.")).
-                              arg(simConnectData->getStatusText()));
-        closeSocket(false);
-        return;
-      }
+    // Read directly from the socket buffer
+    parseTimer.start();
+    bool read = simConnectData->read(socket);
+    parseNsecs += parseTimer.nsecsElapsed();
+
+    if(simConnectData->getStatus() != atools::fs::sc::OK)
+    {
+      // Something went wrong - shutdown
+      QMessageBox::critical(mainWindow, QApplication::applicationName(),
+                            QString(tr("Error reading data from Little Navconnect: %1.")).
+                            arg(simConnectData->getStatusText()));
+      delete newestData;
+      closeSocket(false);
+      return;
+    }
 
+    if(verbose)
+      qDebug() << "readFromSocket 2" << socket->bytesAvailable();
+    if(read)
+    {
+      numPackets++;
       if(verbose)
-        qDebug() << "readFromSocket 2" << socket->bytesAvailable();
-      if(read)
+        qDebug() << "readFromSocket id " << simConnectData->getPacketId();
+
+      if(simConnectData->getPacketId() > 0)
       {
         if(verbose)
-          qDebug() << "readFromSocket id " << simConnectData->getPacketId();
+          qDebug() << "readFromSocket id " << simConnectData->getPacketId() << "replying";
+
+        // Data was read completely and successfully - reply to server
+        atools::fs::sc::SimConnectReply reply;
+        reply.setPacketId(simConnectData->getPacketId());
+        writeReplyToSocket(reply);
 
-        if(simConnectData->getPacketId() > 0)
+        if(socket == nullptr)
         {
-          if(verbose)
-            qDebug() << "readFromSocket id " << simConnectData->getPacketId() << "replying";
+          // Closed due to write error
+          delete newestData;
+          return;
+        }
 
-          // Data was read completely and successfully - reply to server
-          atools::fs::sc::SimConnectReply reply;
-          reply.setPacketId(simConnectData->getPacketId());
-          writeReplyToSocket(reply);
+        // Keep only the newest aircraft packet
+        if(newestData != nullptr)
+        {
+          delete newestData;
+          numDropped++;
         }
-        else if(!simConnectData->getMetars().isEmpty())
+        newestData = simConnectData;
+      }
+      else
+      {
+        if(!simConnectData->getMetars().isEmpty())
         {
           if(verbose)
             qDebug() << "readFromSocket id " << simConnectData->getPacketId() << "metars";
 
+          // Next request is sent by postSimConnectData
           for(const atools::fs::weather::MetarResult& metar : simConnectData->getMetars())
             outstandingReplies.remove(metar.requestIdent);
-
-          // Start request on next invocation of the event queue
-          QTimer::singleShot(0, this, &ConnectClient::flushQueuedRequests);
         }
 
-        // Send around in the application
-        postSimConnectData(*simConnectData);
+        // Weather packets are never dropped - send around in the application
+        postSimConnectData(std::move(*simConnectData));
         delete simConnectData;
         simConnectData = nullptr;
+
+        if(socket == nullptr)
+        {
+          // Closed while handling the data
+          delete newestData;
+          return;
+        }
       }
-      else
-        return;
-    }
-    if(verbose)
-    {
-      qDebug() << "readFromSocket === queuedRequestIdents" << queuedRequestIdents;
-      qDebug() << "readFromSocket outstanding" << outstandingReplies;
+      simConnectData = nullptr;
     }
+    else
+      break;
+  }
+
+  if(newestData != nullptr)
+  {
+    // Send around in the application
+    postSimConnectData(std::move(*newestData));
+    delete newestData;
+  }
+
+  numDroppedPackets += numDropped;
+  if(numPackets > 0)
+    pstats::addSimData(parseNsecs, numPackets, numDropped);
+
+  if(verbose)
+  {
+    qDebug() << "readFromSocket packets" << numPackets << "dropped" << numDropped << "total dropped"
+             << numDroppedPackets << "parse time" << parseNsecs / 1000 << "us";
+    qDebug() << "readFromSocket === queuedRequestIdents" << queuedRequestIdents;
+    qDebug() << "readFromSocket outstanding" << outstandingReplies;
   }
 }
@@ -18,6 +18,7 @@
 #ifndef LITTLENAVMAP_CONNECTCLIENT_H
 #define LITTLENAVMAP_CONNECTCLIENT_H
 
+#include "connect/simdatasnapshot.h"
 #include "fs/sc/simconnectdata.h"
 #include "util/timedcache.h"
 #include "connectdialog.h"
@@ -27,8 +28,13 @@
 #include <QTimer>
 
 class QTcpSocket;
+class QThread;
 class ConnectDialog;
 class MainWindow;
+class SimDataRecorder;
+class SimDataReplay;
+class SimDataServer;
+class SimDataDispatcher;
 
 namespace atools {
 namespace fs {
@@ -76,6 +82,8 @@ public:
 
   /* Request weather. Return value will be empty and the request will be started in background.
    * Signal weatherUpdated is sent if request was finished. Than call this method again.
+   * Missing stations are collected and requested after returning to the event loop. weatherUpdated is sent
+   * once for all replies of such a batch.
    * onlyStation: Do not return weather for interpolated or nearest only. Keeps an internal blacklist. */
   atools::fs::weather::MetarResult requestWeather(const QString& station, const atools::geo::Pos& pos,
                                                   bool onlyStation);
@@ -83,10 +91,17 @@ public:
   bool isFetchAiShip() const;
   bool isFetchAiAircraft() const;
 
+  /* Register consumers of sim data here instead of connecting to dataPacketReceived directly
+   * if they need a limited update rate */
+  SimDataDispatcher *getSimDataDispatcher() const
+  {
+    return dispatcher;
+  }
+
 signals:
   /* Emitted when new data was received from the server (Little Navconnect), SimConnect or X-Plane.
-   * can be aircraft position or weather update */
-  void dataPacketReceived(atools::fs::sc::SimConnectData simConnectData);
+   * can be aircraft position or weather update. The snapshot is shared by all receivers and must not be copied. */
+  void dataPacketReceived(const SimConnectDataPtr& simConnectData);
 
   /* Emitted when a new SimConnect data was received that contains weather data */
   void weatherUpdated();
@@ -107,6 +122,9 @@ private:
   const int DIRECT_RECONNECT_SEC = 5;
   const int FLUSH_QUEUE_MS = 50;
 
+  /* Maximum delay for weatherUpdated while a batch of requests is answered */
+  const int WEATHER_UPDATE_BATCH_MS = 500;
+
   /* Any metar fetched from the Simulator will time out in 15 seconds */
   const int WEATHER_TIMEOUT_FS_SECS = 15;
   const int NOT_AVAILABLE_TIMEOUT_FS_SECS = 300;
@@ -122,9 +140,13 @@ private:
   void postLogMessage(QString message, bool warning);
   void connectedToSimulatorDirect();
   void disconnectedFromSimulatorDirect();
+  void startReplay();
+  void stopReplay();
+  void replayFinished();
   void autoConnectToggled(bool state);
   void requestWeather(const atools::fs::sc::WeatherRequest& weatherRequest);
   void flushQueuedRequests();
+  void emitWeatherUpdated();
   atools::fs::sc::ConnectHandler *handlerByDialogSettings();
   QString simShortName() const;
   QString simName() const;
@@ -145,8 +167,28 @@ private:
   atools::fs::sc::SimConnectData *simConnectData = nullptr;
 
   QTcpSocket *socket = nullptr;
+
+  /* Records all packets if enabled in the configuration file */
+  SimDataRecorder *recorder = nullptr;
+
+  /* Replaces the simulator connection if a replay file is given in the configuration file */
+  SimDataReplay *replay = nullptr;
+  QString replayFilename;
+  float replaySpeed = 1.f;
+
+  /* Receives all packets and distributes them to the consumers */
+  SimDataDispatcher *dispatcher = nullptr;
+
+  /* Local stand-in for Little Navconnect generating traffic if enabled in the configuration file.
+   * Lives in serverThread. */
+  SimDataServer *server = nullptr;
+  QThread *serverThread = nullptr;
+
   /* Used to trigger reconnects on socket base connections */
-  QTimer reconnectNetworkTimer, flushQueuedRequestsTimer;
+  QTimer reconnectNetworkTimer, flushQueuedRequestsTimer, batchRequestsTimer, weatherUpdateTimer;
+
+  /* Weather replies arrived which were not announced by weatherUpdated yet */
+  bool weatherChanged = false;
   MainWindow *mainWindow;
   bool verbose = false;
   atools::util::TimedCache<QString, atools::fs::weather::MetarResult> metarIdentCache;
@@ -161,6 +203,9 @@ private:
   /* Cache holding all weather stations that do not allow a direct report but rather interpolated or nearest */
   atools::util::TimedCache<QString, QString> notAvailableStations;
 
+  /* Outdated packets from the network which were not sent around */
+  quint64 numDroppedPackets = 0;
+
   // have to remember state separately to avoid sending signals when autoconnect fails
   bool socketConnected = false;
 };
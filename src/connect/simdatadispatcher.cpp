@@ -0,0 +1,116 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "connect/simdatadispatcher.h"
+
+#include "fs/sc/simconnectdata.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <limits>
+
+SimDataDispatcher::SimDataDispatcher(QObject *parent)
+  : QObject(parent)
+{
+  clock.start();
+  pendingTimer.setSingleShot(true);
+  connect(&pendingTimer, &QTimer::timeout, this, &SimDataDispatcher::deliverPending);
+}
+
+SimDataDispatcher::~SimDataDispatcher()
+{
+  pendingTimer.stop();
+}
+
+void SimDataDispatcher::addConsumer(const QString& name, int priority, int intervalMs, ConsumerFunc func)
+{
+  qDebug() << Q_FUNC_INFO << name << "priority" << priority << "interval" << intervalMs << "ms";
+
+  consumers.append({name, priority, intervalMs, func, -1L, SimConnectDataPtr()});
+
+  // Keep registration order for equal priorities
+  std::stable_sort(consumers.begin(), consumers.end(), [](const Consumer& c1, const Consumer& c2) -> bool {
+    return c1.priority < c2.priority;
+  });
+}
+
+void SimDataDispatcher::dispatch(const SimConnectDataPtr& data)
+{
+  qint64 now = clock.elapsed();
+
+  // Index based since consumers might call clear()
+  for(int i = 0; i < consumers.size(); i++)
+  {
+    Consumer& consumer = consumers[i];
+    if(isDue(consumer, now))
+    {
+      consumer.lastDeliveryMs = now;
+      consumer.pending.reset();
+      consumer.func(data);
+    }
+    else if(consumer.pending.isNull() || data->getUserAircraftConst().isValid())
+      // Do not replace a pending aircraft update with a weather only packet
+      consumer.pending = data;
+  }
+
+  schedulePending(now);
+}
+
+void SimDataDispatcher::deliverPending()
+{
+  qint64 now = clock.elapsed();
+
+  for(int i = 0; i < consumers.size(); i++)
+  {
+    Consumer& consumer = consumers[i];
+    if(!consumer.pending.isNull() && isDue(consumer, now))
+    {
+      SimConnectDataPtr data;
+      data.swap(consumer.pending);
+      consumer.lastDeliveryMs = now;
+      consumer.func(data);
+    }
+  }
+
+  schedulePending(now);
+}
+
+void SimDataDispatcher::schedulePending(qint64 nowMs)
+{
+  qint64 nextMs = std::numeric_limits<qint64>::max();
+  for(const Consumer& consumer : consumers)
+  {
+    if(!consumer.pending.isNull())
+      nextMs = std::min(nextMs, consumer.lastDeliveryMs + consumer.intervalMs - nowMs);
+  }
+
+  if(nextMs < std::numeric_limits<qint64>::max())
+    pendingTimer.start(static_cast<int>(std::max(nextMs, static_cast<qint64>(0))));
+  else
+    pendingTimer.stop();
+}
+
+void SimDataDispatcher::clear()
+{
+  pendingTimer.stop();
+  for(Consumer& consumer : consumers)
+  {
+    consumer.pending.reset();
+    consumer.lastDeliveryMs = -1L;
+  }
+}
@@ -0,0 +1,89 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_SIMDATADISPATCHER_H
+#define LITTLENAVMAP_SIMDATADISPATCHER_H
+
+#include "connect/simdatasnapshot.h"
+
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QVector>
+
+#include <functional>
+
+/*
+ * Delivers simulator data packets to all registered consumers in order of priority and limits the rate
+ * for each consumer.
+ *
+ * Packets arriving before the interval of a consumer has passed are coalesced. Only the newest one is delivered
+ * once the interval is over. This way a consumer always gets the latest state but is never called more often
+ * than requested. Uses one monotonic clock reading per packet.
+ */
+class SimDataDispatcher :
+  public QObject
+{
+  Q_OBJECT
+
+public:
+  typedef std::function<void (const SimConnectDataPtr& data)> ConsumerFunc;
+
+  SimDataDispatcher(QObject *parent);
+  virtual ~SimDataDispatcher();
+
+  /* Register a consumer. Consumers with lower priority values get packets first.
+   * intervalMs: Minimum time between two deliveries. 0 delivers every packet immediately. */
+  void addConsumer(const QString& name, int priority, int intervalMs, ConsumerFunc func);
+
+  /* Deliver packet to all consumers which are due and keep it for the others */
+  void dispatch(const SimConnectDataPtr& data);
+
+  /* Drop all pending packets and reset timing. The next packet is delivered to all consumers. */
+  void clear();
+
+private:
+  struct Consumer
+  {
+    QString name;
+    int priority, intervalMs;
+    ConsumerFunc func;
+
+    /* Time of last delivery or -1 if nothing was delivered yet */
+    qint64 lastDeliveryMs;
+
+    /* Newest packet not delivered yet */
+    SimConnectDataPtr pending;
+  };
+
+  /* Deliver pending packets which are due */
+  void deliverPending();
+
+  /* Start timer for the pending packet which is due next */
+  void schedulePending(qint64 nowMs);
+
+  bool isDue(const Consumer& consumer, qint64 nowMs) const
+  {
+    return consumer.intervalMs <= 0 || consumer.lastDeliveryMs < 0 ||
+           nowMs - consumer.lastDeliveryMs >= consumer.intervalMs;
+  }
+
+  QVector<Consumer> consumers;
+  QElapsedTimer clock;
+  QTimer pendingTimer;
+};
+
+#endif // LITTLENAVMAP_SIMDATADISPATCHER_H
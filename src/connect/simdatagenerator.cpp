@@ -0,0 +1,124 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "connect/simdatagenerator.h"
+
+#include "fs/sc/simconnectdata.h"
+#include "fs/sc/simconnectreply.h"
+#include "geo/calculations.h"
+
+#include <QDateTime>
+
+#include <cmath>
+
+using atools::geo::Pos;
+using atools::fs::sc::SimConnectData;
+
+SimDataGenerator::SimDataGenerator(const atools::geo::Pos& centerPos, int numAiAircraft, int groundPercent,
+                                   float radiusNm)
+  : center(centerPos), radiusMeter(atools::geo::nmToMeter(radiusNm)), random(1)
+{
+  // User aircraft is always flying
+  vehicles.append(createVehicle(false));
+
+  int numGround = numAiAircraft * groundPercent / 100;
+  for(int i = 0; i < numAiAircraft; i++)
+    vehicles.append(createVehicle(i < numGround));
+}
+
+SimDataGenerator::Vehicle SimDataGenerator::createVehicle(bool ground)
+{
+  std::uniform_real_distribution<float> angleDist(0.f, 360.f), unitDist(0.f, 1.f);
+
+  Vehicle vehicle;
+  vehicle.ground = ground;
+  vehicle.headingDeg = angleDist(random);
+
+  // Spread evenly over the circle area
+  float altitudeFt = ground ? 0.f : 2000.f + unitDist(random) * 36000.f;
+  Pos pos = center.endpoint(radiusMeter * std::sqrt(unitDist(random)), angleDist(random)).normalize();
+  vehicle.pos = vehicle.lastPos = Pos(pos.getLonX(), pos.getLatY(), altitudeFt);
+
+  if(ground)
+  {
+    vehicle.speedKts = unitDist(random) * 20.f;
+    vehicle.turnRateDegPerSec = (unitDist(random) - 0.5f) * 10.f;
+  }
+  else
+  {
+    vehicle.speedKts = 120.f + unitDist(random) * 360.f;
+    vehicle.turnRateDegPerSec = (unitDist(random) - 0.5f) * 2.f;
+  }
+  return vehicle;
+}
+
+void SimDataGenerator::move(Vehicle& vehicle, int elapsedMs)
+{
+  float seconds = elapsedMs / 1000.f;
+
+  if(!vehicle.ground && vehicle.pos.distanceMeterTo(center) > radiusMeter)
+    // Turn back into the area
+    vehicle.headingDeg = vehicle.pos.angleDegTo(center);
+  else
+    vehicle.headingDeg = atools::geo::normalizeCourse(vehicle.headingDeg + vehicle.turnRateDegPerSec * seconds);
+
+  float distMeter = atools::geo::nmToMeter(vehicle.speedKts * seconds / 3600.f);
+  Pos next = vehicle.pos.endpoint(distMeter, vehicle.headingDeg).normalize();
+
+  vehicle.lastPos = vehicle.pos;
+  vehicle.pos = Pos(next.getLonX(), next.getLatY(), vehicle.pos.getAltitude());
+}
+
+atools::fs::sc::SimConnectData SimDataGenerator::next(int elapsedMs)
+{
+  for(Vehicle& vehicle : vehicles)
+    move(vehicle, elapsedMs);
+
+  // Build the user aircraft in the same way as the debug aircraft on the map
+  const Vehicle& user = vehicles.first();
+  SimConnectData data = SimConnectData::buildDebugForPosition(user.pos, user.lastPos);
+  data.setPacketId(++packetId);
+
+  QVector<atools::fs::sc::SimConnectAircraft>& aiAircraft = data.getAiAircraft();
+  aiAircraft.reserve(vehicles.size() - 1);
+  for(int i = 1; i < vehicles.size(); i++)
+  {
+    const Vehicle& vehicle = vehicles.at(i);
+    atools::fs::sc::SimConnectAircraft aircraft =
+      SimConnectData::buildDebugForPosition(vehicle.pos, vehicle.lastPos).getUserAircraftConst();
+    aircraft.setFlags(vehicle.ground ? atools::fs::sc::ON_GROUND : atools::fs::sc::NONE);
+    aiAircraft.append(aircraft);
+  }
+  return data;
+}
+
+atools::fs::weather::MetarResult SimDataGenerator::metar(const atools::fs::sc::WeatherRequest& request) const
+{
+  QDateTime now = QDateTime::currentDateTimeUtc();
+  QString report = QString("%1 " + now.toString("ddhhmm") + "Z 27010KT 9999 FEW030 15/08 Q1013");
+
+  atools::fs::weather::MetarResult result;
+  result.requestIdent = request.getStation();
+  result.requestPos = request.getPosition();
+  result.timestamp = now;
+
+  if(request.getStation().size() >= 4)
+    result.metarForStation = report.arg(request.getStation());
+  result.metarForNearest = report.arg("XXXX");
+  result.metarForInterpolated = report.arg(request.getStation());
+  return result;
+}
@@ -0,0 +1,77 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_SIMDATAGENERATOR_H
+#define LITTLENAVMAP_SIMDATAGENERATOR_H
+
+#include "geo/pos.h"
+
+#include <QVector>
+
+#include <random>
+
+namespace atools {
+namespace fs {
+namespace sc {
+class SimConnectData;
+class WeatherRequest;
+}
+namespace weather {
+struct MetarResult;
+}
+}
+}
+
+/*
+ * Generates synthetic simulator data with a user aircraft and a configurable number of AI aircraft
+ * moving around a center position. Airborne aircraft turn back when leaving the radius. Aircraft on ground taxi slowly.
+ *
+ * Uses a fixed seed so the same parameters always produce the same traffic.
+ */
+class SimDataGenerator
+{
+public:
+  /* groundPercent: Percentage of AI aircraft on ground. radiusNm: Area where the traffic is created. */
+  SimDataGenerator(const atools::geo::Pos& centerPos, int numAiAircraft, int groundPercent, float radiusNm);
+
+  /* Move all aircraft by the given time and return a new packet */
+  atools::fs::sc::SimConnectData next(int elapsedMs);
+
+  /* Build weather for a request. Stations with less than four characters only have nearest and
+   * interpolated reports to trigger the fallback paths of the client. */
+  atools::fs::weather::MetarResult metar(const atools::fs::sc::WeatherRequest& request) const;
+
+private:
+  struct Vehicle
+  {
+    atools::geo::Pos pos, lastPos;
+    float headingDeg, speedKts, turnRateDegPerSec;
+    bool ground;
+  };
+
+  Vehicle createVehicle(bool ground);
+  void move(Vehicle& vehicle, int elapsedMs);
+
+  /* First one is the user aircraft */
+  QVector<Vehicle> vehicles;
+  atools::geo::Pos center;
+  float radiusMeter;
+  int packetId = 0;
+  std::mt19937 random;
+};
+
+#endif // LITTLENAVMAP_SIMDATAGENERATOR_H
@@ -0,0 +1,82 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "connect/simdatarecorder.h"
+
+#include "fs/sc/simconnectdata.h"
+
+#include <QDataStream>
+#include <QDebug>
+
+SimDataRecorder::SimDataRecorder(const QString& filename)
+  : file(filename)
+{
+}
+
+SimDataRecorder::~SimDataRecorder()
+{
+  close();
+}
+
+bool SimDataRecorder::open()
+{
+  if(file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_5);
+    out << simrec::FILE_MAGIC_NUMBER << simrec::FILE_VERSION;
+
+    timer.start();
+    numRecorded = 0;
+    qInfo() << Q_FUNC_INFO << "Recording simulator data to" << file.fileName();
+    return true;
+  }
+  else
+  {
+    qWarning() << "Cannot open recording" << file.fileName() << ":" << file.errorString();
+    return false;
+  }
+}
+
+void SimDataRecorder::close()
+{
+  if(file.isOpen())
+  {
+    qInfo() << Q_FUNC_INFO << "Recorded" << numRecorded << "packets to" << file.fileName();
+    file.close();
+  }
+}
+
+void SimDataRecorder::record(atools::fs::sc::SimConnectData& data)
+{
+  if(!file.isOpen())
+    return;
+
+  QDataStream out(&file);
+  out.setVersion(QDataStream::Qt_5_5);
+  out << static_cast<qint64>(timer.elapsed());
+
+  data.write(&file);
+
+  if(data.getStatus() != atools::fs::sc::OK || out.status() != QDataStream::Ok)
+  {
+    qWarning() << "Cannot write recording" << file.fileName() << ":" << data.getStatusText() << file.errorString();
+    close();
+  }
+  else
+    numRecorded++;
+}
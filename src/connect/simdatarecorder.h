@@ -0,0 +1,74 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_SIMDATARECORDER_H
+#define LITTLENAVMAP_SIMDATARECORDER_H
+
+#include <QElapsedTimer>
+#include <QFile>
+
+namespace atools {
+namespace fs {
+namespace sc {
+class SimConnectData;
+}
+}
+}
+
+namespace simrec {
+
+/* Header of a recording file. Followed by records consisting of a qint64 timestamp in milliseconds since the
+ * start of the recording and the packet as written by SimConnectData::write */
+const quint32 FILE_MAGIC_NUMBER = 0x52444D4E;
+const quint16 FILE_VERSION = 1;
+
+}
+
+/*
+ * Writes all simulator data packets with a timestamp into a binary file which can be used
+ * by SimDataReplay to play back a session without simulator.
+ */
+class SimDataRecorder
+{
+public:
+  SimDataRecorder(const QString& filename);
+  ~SimDataRecorder();
+
+  /* Creates or truncates the file and writes the header. Returns false on error. */
+  bool open();
+  void close();
+
+  /* Append packet with the time elapsed since opening */
+  void record(atools::fs::sc::SimConnectData& data);
+
+  bool isOpen() const
+  {
+    return file.isOpen();
+  }
+
+  int getNumRecorded() const
+  {
+    return numRecorded;
+  }
+
+private:
+  QFile file;
+  QElapsedTimer timer;
+  int numRecorded = 0;
+};
+
+#endif // LITTLENAVMAP_SIMDATARECORDER_H
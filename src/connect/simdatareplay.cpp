@@ -0,0 +1,136 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "connect/simdatareplay.h"
+
+#include "connect/simdatarecorder.h"
+
+#include <QDataStream>
+#include <QDebug>
+
+SimDataReplay::SimDataReplay(const QString& recordingFile, float speedFactor, QObject *parent)
+  : QObject(parent), filename(recordingFile), file(recordingFile), speed(speedFactor)
+{
+  timer.setSingleShot(true);
+  connect(&timer, &QTimer::timeout, this, &SimDataReplay::replayNext);
+}
+
+SimDataReplay::~SimDataReplay()
+{
+  timer.stop();
+  file.close();
+}
+
+bool SimDataReplay::start()
+{
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    qWarning() << "Cannot open recording" << filename << ":" << file.errorString();
+    return false;
+  }
+
+  QDataStream in(&file);
+  in.setVersion(QDataStream::Qt_5_5);
+  quint32 magicNumber;
+  quint16 version;
+  in >> magicNumber >> version;
+
+  if(magicNumber != simrec::FILE_MAGIC_NUMBER || version != simrec::FILE_VERSION)
+  {
+    qWarning() << "Cannot read recording" << filename << ": Invalid magic number or version"
+               << magicNumber << version;
+    file.close();
+    return false;
+  }
+
+  if(!readNext())
+  {
+    qWarning() << "Recording" << filename << "is empty";
+    file.close();
+    return false;
+  }
+
+  qInfo() << Q_FUNC_INFO << "Replaying" << filename << "speed" << speed;
+
+  numReplayed = 0;
+  firstTimestampMs = nextTimestampMs;
+  replayTimer.start();
+  timer.start(0);
+  return true;
+}
+
+void SimDataReplay::stop()
+{
+  if(file.isOpen())
+  {
+    timer.stop();
+    file.close();
+
+    qint64 elapsed = replayTimer.elapsed();
+    qInfo() << Q_FUNC_INFO << "Replayed" << numReplayed << "packets in" << elapsed << "ms"
+             << (elapsed > 0 ? numReplayed * 1000. / elapsed : 0.) << "packets per second";
+  }
+}
+
+void SimDataReplay::replayNext()
+{
+  if(!file.isOpen())
+    return;
+
+  emit postSimConnectData(nextData);
+  numReplayed++;
+
+  if(readNext())
+    scheduleNext();
+  else
+  {
+    stop();
+    emit replayFinished();
+  }
+}
+
+bool SimDataReplay::readNext()
+{
+  if(file.atEnd())
+    return false;
+
+  QDataStream in(&file);
+  in.setVersion(QDataStream::Qt_5_5);
+  in >> nextTimestampMs;
+
+  nextData = atools::fs::sc::SimConnectData();
+  if(in.status() != QDataStream::Ok || !nextData.read(&file) || nextData.getStatus() != atools::fs::sc::OK)
+  {
+    qWarning() << "Cannot read recording" << filename << ": Truncated or invalid packet" << nextData.getStatusText();
+    return false;
+  }
+  return true;
+}
+
+void SimDataReplay::scheduleNext()
+{
+  if(speed > 0.f)
+  {
+    // Keep the timing relative to the start to avoid accumulating timer delays
+    qint64 dueMs = static_cast<qint64>((nextTimestampMs - firstTimestampMs) / speed);
+    qint64 delayMs = dueMs - replayTimer.elapsed();
+    timer.start(delayMs > 0 ? static_cast<int>(delayMs) : 0);
+  }
+  else
+    // Give the event loop a chance to paint between packets
+    timer.start(0);
+}
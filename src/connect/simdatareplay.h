@@ -0,0 +1,83 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_SIMDATAREPLAY_H
+#define LITTLENAVMAP_SIMDATAREPLAY_H
+
+#include "fs/sc/simconnectdata.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTimer>
+
+/*
+ * Plays back a file written by SimDataRecorder in the event loop. Packets are sent using the original timing,
+ * a multiple of it or as fast as the event loop allows.
+ * Prints the number of packets and the throughput when finished which allows reproducible benchmarks.
+ */
+class SimDataReplay :
+  public QObject
+{
+  Q_OBJECT
+
+public:
+  /* speedFactor: 1 for real time, 2 for double speed and so on. 0 or lower replays as fast as possible. */
+  SimDataReplay(const QString& recordingFile, float speedFactor, QObject *parent);
+  virtual ~SimDataReplay();
+
+  /* Opens the file and starts sending packets. Returns false if the file cannot be read. */
+  bool start();
+  void stop();
+
+  bool isActive() const
+  {
+    return file.isOpen();
+  }
+
+  const QString& getFilename() const
+  {
+    return filename;
+  }
+
+signals:
+  /* Same as DataReaderThread::postSimConnectData */
+  void postSimConnectData(atools::fs::sc::SimConnectData dataPacket);
+
+  /* Sent when the end of the file was reached or on error */
+  void replayFinished();
+
+private:
+  void replayNext();
+  bool readNext();
+  void scheduleNext();
+
+  QString filename;
+  QFile file;
+  QTimer timer;
+
+  /* Started with the first packet */
+  QElapsedTimer replayTimer;
+
+  /* Read ahead packet */
+  atools::fs::sc::SimConnectData nextData;
+  qint64 nextTimestampMs = 0L, firstTimestampMs = -1L;
+
+  float speed = 1.f;
+  int numReplayed = 0;
+};
+
+#endif // LITTLENAVMAP_SIMDATAREPLAY_H
@@ -0,0 +1,185 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "connect/simdataserver.h"
+
+#include "connect/simdatagenerator.h"
+#include "fs/sc/simconnectdata.h"
+#include "fs/sc/simconnectreply.h"
+
+#include <QDebug>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+/* Radius around the center where traffic is generated */
+const static float TRAFFIC_RADIUS_NM = 100.f;
+
+SimDataServer::SimDataServer(quint16 portParam, const atools::geo::Pos& centerParam, int numAiAircraftParam,
+                             int groundPercentParam, int updateRateMsParam)
+  : QObject(nullptr), port(portParam), center(centerParam), numAiAircraft(numAiAircraftParam),
+  groundPercent(groundPercentParam), updateRateMs(updateRateMsParam)
+{
+}
+
+SimDataServer::~SimDataServer()
+{
+  stop();
+}
+
+void SimDataServer::start()
+{
+  stop();
+
+  server = new QTcpServer(this);
+  if(!server->listen(QHostAddress::LocalHost, port))
+  {
+    qWarning() << "Cannot start simulator data server on port" << port << ":" << server->errorString();
+    delete server;
+    server = nullptr;
+    return;
+  }
+
+  connect(server, &QTcpServer::newConnection, this, &SimDataServer::newConnection);
+
+  generator = new SimDataGenerator(center, numAiAircraft, groundPercent, TRAFFIC_RADIUS_NM);
+
+  // Create timer here to have it in the same thread
+  updateTimer = new QTimer(this);
+  updateTimer->setInterval(updateRateMs);
+  connect(updateTimer, &QTimer::timeout, this, &SimDataServer::sendPacket);
+
+  qInfo() << Q_FUNC_INFO << "Simulator data server listening on port" << server->serverPort()
+          << "AI aircraft" << numAiAircraft << "on ground" << groundPercent << "%"
+          << "update rate" << updateRateMs << "ms";
+}
+
+void SimDataServer::stop()
+{
+  delete updateTimer;
+  updateTimer = nullptr;
+
+  closeSocket();
+
+  if(server != nullptr)
+  {
+    server->close();
+    delete server;
+    server = nullptr;
+  }
+
+  delete generator;
+  generator = nullptr;
+}
+
+void SimDataServer::newConnection()
+{
+  QTcpSocket *newSocket = server->nextPendingConnection();
+
+  if(socket != nullptr)
+  {
+    qWarning() << Q_FUNC_INFO << "Already connected. Rejecting" << newSocket->peerAddress();
+    newSocket->abort();
+    newSocket->deleteLater();
+    return;
+  }
+
+  qInfo() << Q_FUNC_INFO << "Client connected from" << newSocket->peerAddress();
+
+  socket = newSocket;
+  connect(socket, &QTcpSocket::readyRead, this, &SimDataServer::readReplies);
+  connect(socket, &QTcpSocket::disconnected, this, &SimDataServer::socketDisconnected);
+
+  lastUpdate.start();
+  updateTimer->start();
+}
+
+void SimDataServer::socketDisconnected()
+{
+  qInfo() << Q_FUNC_INFO << "Client disconnected";
+  updateTimer->stop();
+  closeSocket();
+}
+
+void SimDataServer::closeSocket()
+{
+  if(socket != nullptr)
+  {
+    socket->disconnect(this);
+    socket->abort();
+    socket->deleteLater();
+    socket = nullptr;
+  }
+
+  delete reply;
+  reply = nullptr;
+}
+
+void SimDataServer::sendPacket()
+{
+  if(socket == nullptr || generator == nullptr)
+    return;
+
+  atools::fs::sc::SimConnectData data = generator->next(static_cast<int>(lastUpdate.restart()));
+  writeData(data);
+}
+
+void SimDataServer::readReplies()
+{
+  while(socket != nullptr && socket->bytesAvailable())
+  {
+    if(reply == nullptr)
+      // Need to keep the reply since this method can be called multiple times until it is complete
+      reply = new atools::fs::sc::SimConnectReply;
+
+    bool read = reply->read(socket);
+    if(reply->getStatus() != atools::fs::sc::OK)
+    {
+      qWarning() << Q_FUNC_INFO << "Error reading reply" << reply->getStatusText();
+      closeSocket();
+      return;
+    }
+
+    if(!read)
+      return;
+
+    if(reply->getCommand() & atools::fs::sc::CMD_WEATHER_REQUEST)
+    {
+      // Answer with a weather only packet like Little Navconnect
+      atools::fs::sc::SimConnectData data;
+      data.setMetars({generator->metar(reply->getWeatherRequest())});
+      writeData(data);
+    }
+
+    delete reply;
+    reply = nullptr;
+  }
+}
+
+void SimDataServer::writeData(atools::fs::sc::SimConnectData& data)
+{
+  if(socket == nullptr)
+    return;
+
+  data.write(socket);
+
+  if(data.getStatus() != atools::fs::sc::OK)
+  {
+    qWarning() << Q_FUNC_INFO << "Error writing data" << data.getStatusText();
+    closeSocket();
+  }
+}
@@ -0,0 +1,88 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_SIMDATASERVER_H
+#define LITTLENAVMAP_SIMDATASERVER_H
+
+#include "geo/pos.h"
+
+#include <QElapsedTimer>
+#include <QObject>
+
+class QTcpServer;
+class QTimer;
+class QTcpSocket;
+class SimDataGenerator;
+
+namespace atools {
+namespace fs {
+namespace sc {
+class SimConnectData;
+class SimConnectReply;
+}
+}
+}
+
+/*
+ * Stand-in for Little Navconnect which sends synthetic traffic from SimDataGenerator over TCP and answers
+ * weather requests. Accepts one client at a time.
+ *
+ * Is moved to an own thread by ConnectClient to keep generating and writing packets out of the GUI thread.
+ * Sockets, timers and the generator are created in start() and therefore belong to that thread.
+ *
+ * Connect to it using "localhost" and the configured port in the connect dialog to load test the
+ * network path of ConnectClient without simulator.
+ */
+class SimDataServer :
+  public QObject
+{
+  Q_OBJECT
+
+public:
+  SimDataServer(quint16 portParam, const atools::geo::Pos& centerParam, int numAiAircraftParam,
+                int groundPercentParam, int updateRateMsParam);
+  virtual ~SimDataServer();
+
+  /* Start listening on localhost. Call in the thread owning this object, e.g. by connecting QThread::started.
+   * Logs a warning if the port cannot be opened. */
+  void start();
+  void stop();
+
+private:
+  void newConnection();
+  void socketDisconnected();
+  void readReplies();
+  void sendPacket();
+  void writeData(atools::fs::sc::SimConnectData& data);
+  void closeSocket();
+
+  QTcpServer *server = nullptr;
+  QTcpSocket *socket = nullptr;
+  SimDataGenerator *generator = nullptr;
+
+  /* Kept until the reply is read completely */
+  atools::fs::sc::SimConnectReply *reply = nullptr;
+
+  QTimer *updateTimer = nullptr;
+  QElapsedTimer lastUpdate;
+
+  quint16 port;
+  atools::geo::Pos center;
+  int numAiAircraft, groundPercent, updateRateMs;
+};
+
+#endif // LITTLENAVMAP_SIMDATASERVER_H
@@ -0,0 +1,35 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "connect/simdatasnapshot.h"
+
+#include "fs/sc/simconnectdata.h"
+
+namespace simdata {
+
+SimConnectDataPtr createSnapshot(atools::fs::sc::SimConnectData&& data)
+{
+  return SimConnectDataPtr(new atools::fs::sc::SimConnectData(std::move(data)));
+}
+
+const SimConnectDataPtr& emptySnapshot()
+{
+  static const SimConnectDataPtr EMPTY(new atools::fs::sc::SimConnectData);
+  return EMPTY;
+}
+
+} // namespace simdata
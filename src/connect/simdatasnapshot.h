@@ -0,0 +1,45 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_SIMDATASNAPSHOT_H
+#define LITTLENAVMAP_SIMDATASNAPSHOT_H
+
+#include <QSharedPointer>
+
+namespace atools {
+namespace fs {
+namespace sc {
+class SimConnectData;
+}
+}
+}
+
+/* Immutable and reference counted simulator data packet. One instance is created for each received packet
+ * and shared by all consumers. Never null if created by the functions below. */
+typedef QSharedPointer<const atools::fs::sc::SimConnectData> SimConnectDataPtr;
+
+namespace simdata {
+
+/* Create a snapshot by moving the packet to the heap. The packet is not copied if possible. */
+SimConnectDataPtr createSnapshot(atools::fs::sc::SimConnectData&& data);
+
+/* Shared snapshot containing no data. Used to reset consumers. */
+const SimConnectDataPtr& emptySnapshot();
+
+} // namespace simdata
+
+#endif // LITTLENAVMAP_SIMDATASNAPSHOT_H
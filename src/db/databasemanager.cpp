@@ -32,6 +32,8 @@
 #include "fs/navdatabase.h"
 #include "sql/sqlutil.h"
 #include "sql/sqltransaction.h"
+#include "sql/sqlrecord.h"
+#include "exception.h"
 #include "gui/errorhandler.h"
 #include "gui/mainwindow.h"
 #include "ui_mainwindow.h"
@@ -479,6 +481,12 @@ void DatabaseManager::checkCopyAndPrepareDatabases()
           atools::gui::Application::processEventsExtended();
           NavDatabase::runPreparationScript(tempDb);
 
+          dialog->setText(tr("Preparing %1 Database: Creating search index ...").
+                          arg(FsPaths::typeToName(FsPaths::NAVIGRAPH)));
+          atools::gui::Application::processEventsExtended();
+          createTextSearchIndexes(&tempDb);
+          createSpatialIndexes(&tempDb);
+
           dialog->setText(tr("Preparing %1 Database: Analyzing ...").arg(FsPaths::typeToName(FsPaths::NAVIGRAPH)));
           atools::gui::Application::processEventsExtended();
           tempDb.analyze();
@@ -508,6 +516,8 @@ void DatabaseManager::checkCopyAndPrepareDatabases()
     SqlDatabase tempDb(DATABASE_NAME_TEMP);
     openDatabaseFile(&tempDb, settingsDb, false /* readonly */, true /* createSchema */);
     NavDatabase::runPreparationScript(tempDb);
+    createTextSearchIndexes(&tempDb);
+    createSpatialIndexes(&tempDb);
     tempDb.analyze();
     closeDatabaseFile(&tempDb);
 
@@ -515,6 +525,102 @@ void DatabaseManager::checkCopyAndPrepareDatabases()
   }
 }
 
+void DatabaseManager::createTextSearchIndexes(atools::sql::SqlDatabase *db)
+{
+  struct TextSearchTable
+  {
+    QString table, idColumn /* Used as rowid */;
+    QStringList columns; /* Text columns to index */
+  };
+
+  static const QVector<TextSearchTable> TEXT_SEARCH_TABLES =
+  {
+    {"airport", "airport_id", {"ident", "name", "city", "state", "country"}},
+    {"nav_search", "nav_search_id", {"ident", "name"}}
+  };
+
+  SqlUtil util(db);
+  for(const TextSearchTable& tableDef : TEXT_SEARCH_TABLES)
+  {
+    const QString& table = tableDef.table;
+    QString ftsTable = dm::textSearchTableName(table);
+
+    if(!util.hasTable(table))
+      continue;
+
+    // Skip columns not existing in older schemas
+    atools::sql::SqlRecord tableCols = db->record(table);
+    QStringList columns;
+    for(const QString& column : tableDef.columns)
+    {
+      if(tableCols.contains(column))
+        columns.append(column);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    try
+    {
+      SqlTransaction transaction(db);
+      db->exec("drop table if exists " + ftsTable);
+
+      // External content table - text is not duplicated. Database is read only after loading.
+      db->exec(QString("create virtual table %1 using fts5(%2, content='%3', content_rowid='%4')").
+               arg(ftsTable).arg(columns.join(", ")).arg(table).arg(tableDef.idColumn));
+      db->exec(QString("insert into %1(%1) values('rebuild')").arg(ftsTable));
+      transaction.commit();
+
+      qDebug() << Q_FUNC_INFO << "Created" << ftsTable << "in" << timer.elapsed() << "ms";
+    }
+    catch(atools::Exception& e)
+    {
+      // Most likely SQLite compiled without FTS5
+      qWarning() << "Cannot create text search index" << ftsTable << ":" << e.what();
+    }
+  }
+}
+
+void DatabaseManager::createSpatialIndexes(atools::sql::SqlDatabase *db)
+{
+  // Table and column used as R*Tree id
+  static const QVector<std::pair<QString, QString> > SPATIAL_INDEX_TABLES =
+  {
+    {"airport", "airport_id"},
+    {"nav_search", "nav_search_id"}
+  };
+
+  SqlUtil util(db);
+  for(const std::pair<QString, QString>& tableDef : SPATIAL_INDEX_TABLES)
+  {
+    QString rtreeTable = dm::spatialIndexTableName(tableDef.first);
+
+    if(!util.hasTable(tableDef.first))
+      continue;
+
+    QElapsedTimer timer;
+    timer.start();
+    try
+    {
+      SqlTransaction transaction(db);
+      db->exec("drop table if exists " + rtreeTable);
+
+      // Points are stored as rectangles with zero size
+      db->exec(QString("create virtual table %1 using rtree(id, min_lonx, max_lonx, min_laty, max_laty)").
+               arg(rtreeTable));
+      db->exec(QString("insert into %1 select %2, lonx, lonx, laty, laty from %3").
+               arg(rtreeTable).arg(tableDef.second).arg(tableDef.first));
+      transaction.commit();
+
+      qDebug() << Q_FUNC_INFO << "Created" << rtreeTable << "in" << timer.elapsed() << "ms";
+    }
+    catch(atools::Exception& e)
+    {
+      // Most likely SQLite compiled without R*Tree
+      qWarning() << "Cannot create spatial index" << rtreeTable << ":" << e.what();
+    }
+  }
+}
+
 QString DatabaseManager::getCurrentSimulatorBasePath() const
 {
   return getSimulatorBasePath(currentFsType);
@@ -816,6 +922,37 @@ void DatabaseManager::closeOnlineDatabase()
   closeDatabaseFile(databaseOnline);
 }
 
+QString DatabaseManager::getOnlineDatabaseShadowFile() const
+{
+  QString onlineFile = databaseDirectory + QDir::separator() + lnm::DATABASE_PREFIX + "onlinedata" +
+                       lnm::DATABASE_SUFFIX;
+  QString shadowFile = databaseDirectory + QDir::separator() + lnm::DATABASE_PREFIX + "onlinedata_shadow" +
+                       lnm::DATABASE_SUFFIX;
+
+  // Files change their role with each swap
+  return databaseOnline->databaseName() == shadowFile ? onlineFile : shadowFile;
+}
+
+void DatabaseManager::swapOnlineDatabase()
+{
+  QString file = getOnlineDatabaseShadowFile();
+  closeOnlineDatabase();
+
+  try
+  {
+    openDatabaseFileInternal(databaseOnline, file, false /* readonly */, false /* createSchema */,
+                             false /* exclusive */, false /* auto transactions */);
+  }
+  catch(atools::Exception& e)
+  {
+    ATOOLS_HANDLE_EXCEPTION(e);
+  }
+  catch(...)
+  {
+    ATOOLS_HANDLE_UNKNOWN_EXCEPTION;
+  }
+}
+
 void DatabaseManager::openAllDatabases()
 {
   QString simDbFile = buildDatabaseFileName(currentFsType);
@@ -1280,6 +1417,9 @@ bool DatabaseManager::loadScenery(atools::sql::SqlDatabase *db)
     atools::fs::NavDatabase nd(&navDatabaseOpts, db, &errors, GIT_REVISION);
     QString sceneryCfgCodec = selectedFsType == atools::fs::FsPaths::P3D_V4 ? "UTF-8" : QString();
     nd.create(sceneryCfgCodec);
+
+    createTextSearchIndexes(db);
+    createSpatialIndexes(db);
   }
   catch(atools::Exception& e)
   {
@@ -101,6 +101,14 @@ public:
   void closeUserDatabase();
   void closeOnlineDatabase();
 
+  /* Online network data is written into a shadow file in the background and swapped with the current one
+   * when done. Returns the file which is not used by the online database connection. */
+  QString getOnlineDatabaseShadowFile() const;
+
+  /* Closes the online database and opens the shadow file instead. All queries on the online database have
+   * to be deleted before and prepared again after calling this. */
+  void swapOnlineDatabase();
+
   /* Close all simulator databases - not the user database.
    * Will not return if an exception is caught during opening. */
   void closeDatabases();
@@ -216,6 +224,14 @@ private:
   void updateSimulatorFlags();
   void updateSimulatorPathsFromDialog();
   bool loadScenery(atools::sql::SqlDatabase *db);
+
+  /* Creates the optional FTS5 text search tables for airport and navaid search. Prints a warning and
+   * leaves the tables out if SQLite was built without FTS5. Search falls back to "like" in this case. */
+  static void createTextSearchIndexes(atools::sql::SqlDatabase *db);
+
+  /* Creates the optional R*Tree tables on coordinates for the airport and navaid distance search.
+   * Prints a warning and leaves the tables out if SQLite was built without R*Tree support. */
+  static void createSpatialIndexes(atools::sql::SqlDatabase *db);
   void correctSimulatorType();
   QMessageBox *showSimpleProgressDialog(const QString& message);
   void deleteSimpleProgressDialog(QMessageBox *messageBox);
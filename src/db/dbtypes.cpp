@@ -23,6 +23,20 @@
 
 using atools::fs::FsPaths;
 
+namespace dm {
+
+QString textSearchTableName(const QString& table)
+{
+  return table + "_fts";
+}
+
+QString spatialIndexTableName(const QString& table)
+{
+  return table + "_rtree";
+}
+
+}
+
 void SimulatorTypeMap::fillDefault()
 {
   for(atools::fs::FsPaths::SimulatorType type : FsPaths::getAllSimulatorTypes())
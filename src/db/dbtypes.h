@@ -35,6 +35,16 @@ struct FsPathType
 
 QDebug operator<<(QDebug out, const FsPathType& record);
 
+namespace dm {
+
+/* Name of the optional SQLite FTS5 text search table for a table. E.g. "airport_fts" for "airport" */
+QString textSearchTableName(const QString& table);
+
+/* Name of the optional SQLite R*Tree table for coordinates of a table. E.g. "airport_rtree" for "airport" */
+QString spatialIndexTableName(const QString& table);
+
+}
+
 QDataStream& operator<<(QDataStream& out, const FsPathType& obj);
 QDataStream& operator>>(QDataStream& in, FsPathType& obj);
 
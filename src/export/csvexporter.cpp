@@ -173,30 +173,42 @@ int CsvExporter::selectionAsCsv(QTableView *view, bool header, bool rows, QStrin
       // Copy full rows
       QTextStream stream(&result, QIODevice::WriteOnly);
       QHeaderView *headerView = view->horizontalHeader();
+      bool addFields = !additionalHeader.isEmpty() && additionalFields;
+
+      // Get logical indexes of all visible columns in visual order once instead of for each row
+      QVector<int> logicalColumns;
+      for(int i = 0; i < model->columnCount(); i++)
+        if(!view->isColumnHidden(i))
+          logicalColumns.append(headerView->logicalIndex(i));
+
       if(header)
       {
         // Build CSV header
         QStringList headers;
-        for(int i = 0; i < model->columnCount(); i++)
-          if(!view->isColumnHidden(i))
-            headers.append(model->headerData(headerView->logicalIndex(i), Qt::Horizontal).
-                           toString().replace("-\n", "").replace("\n", " "));
+        for(int col : logicalColumns)
+          headers.append(model->headerData(col, Qt::Horizontal).toString().replace("-\n", "").replace("\n", " "));
 
-        stream << exporter.getResultSetHeader(headers) +
-        (additionalHeader.isEmpty() || !additionalFields ? QString() : ";" + additionalHeader.join(";")) << endl;
+        stream << exporter.getResultSetHeader(headers);
+        if(addFields)
+          stream << ";" << additionalHeader.join(";");
+        stream << "\n";
       }
 
+      QVariantList vars;
       for(QItemSelectionRange rng : selection->selection())
       {
         // Add data
         for(int row = rng.top(); row <= rng.bottom(); ++row)
         {
-          QVariantList vars;
-          for(int i = 0; i < model->columnCount(); i++)
-            if(!view->isColumnHidden(i))
-              vars.append(model->data(model->index(row, headerView->logicalIndex(i))));
-          stream << exporter.getResultSetRow(vars) +
-          (additionalHeader.isEmpty() || !additionalFields ? QString() : ";" + additionalFields(row).join(";")) << endl;
+          vars.clear();
+          for(int col : logicalColumns)
+            vars.append(model->data(model->index(row, col)));
+
+          // Avoid endl which flushes the stream for each row
+          stream << exporter.getResultSetRow(vars);
+          if(addFields)
+            stream << ";" << additionalFields(row).join(";");
+          stream << "\n";
 
           exported++;
         }
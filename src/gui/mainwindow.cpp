@@ -29,6 +29,7 @@
 #include "route/routealtitude.h"
 #include "weather/weatherreporter.h"
 #include "connect/connectclient.h"
+#include "connect/simdatadispatcher.h"
 #include "common/elevationprovider.h"
 #include "db/databasemanager.h"
 #include "gui/dialog.h"
@@ -1203,14 +1204,42 @@ void MainWindow::connectAllSlots()
   ConnectClient *connectClient = NavApp::getConnectClient();
   connect(ui->actionConnectSimulator, &QAction::triggered, connectClient, &ConnectClient::connectToServerDialog);
 
+  // Sim data consumers ordered by priority with their update intervals ==========================
+  SimDataDispatcher *dispatcher = connectClient->getSimDataDispatcher();
+
   // Deliver first to route controller to update active leg and distances
-  connect(connectClient, &ConnectClient::dataPacketReceived, routeController, &RouteController::simDataChanged);
+  dispatcher->addConsumer("Route", 0, RouteController::MIN_SIM_UPDATE_TIME_MS, [this](const SimConnectDataPtr& data)
+  {
+    routeController->simDataChanged(data);
+  });
 
-  connect(connectClient, &ConnectClient::dataPacketReceived, mapWidget, &MapWidget::simDataChanged);
-  connect(connectClient, &ConnectClient::dataPacketReceived, profileWidget, &ProfileWidget::simDataChanged);
-  connect(connectClient, &ConnectClient::dataPacketReceived, infoController, &InfoController::simDataChanged);
-  connect(connectClient, &ConnectClient::dataPacketReceived,
-          NavApp::getAircraftPerfController(), &AircraftPerfController::simDataChanged);
+  // Map, profile and performance need every packet for tracks and averages
+  dispatcher->addConsumer("Map", 10, 0, [this](const SimConnectDataPtr& data)
+  {
+    mapWidget->simDataChanged(data);
+  });
+  dispatcher->addConsumer("Map tooltip", 11, MapWidget::MAX_SIM_UPDATE_TOOLTIP_MS, [this](const SimConnectDataPtr& data)
+  {
+    mapWidget->simDataChangedTooltip(data);
+  });
+  dispatcher->addConsumer("Profile", 20, 0, [this](const SimConnectDataPtr& data)
+  {
+    profileWidget->simDataChanged(data);
+  });
+  dispatcher->addConsumer("Information", 30, InfoController::MIN_SIM_UPDATE_TIME_MS,
+                          [this](const SimConnectDataPtr& data)
+  {
+    infoController->simDataChanged(data);
+  });
+  dispatcher->addConsumer("Information bearing", 31, InfoController::MIN_SIM_UPDATE_BEARING_TIME_MS,
+                          [this](const SimConnectDataPtr& data)
+  {
+    infoController->simDataChangedBearing(data);
+  });
+  dispatcher->addConsumer("Aircraft performance", 40, 0, [](const SimConnectDataPtr& data)
+  {
+    NavApp::getAircraftPerfController()->simDataChanged(data);
+  });
 
   connect(connectClient, &ConnectClient::disconnectedFromSimulator, routeController,
           &RouteController::disconnectedFromSimulator);
@@ -1237,6 +1266,8 @@ void MainWindow::connectAllSlots()
   connect(weatherReporter, &WeatherReporter::weatherUpdated, infoController, &InfoController::updateAirport);
   connect(weatherReporter, &WeatherReporter::weatherUpdated, mapWidget, &MapWidget::weatherUpdated);
 
+  // Clear parsed metars first
+  connect(connectClient, &ConnectClient::weatherUpdated, weatherReporter, &WeatherReporter::clearMetarCache);
   connect(connectClient, &ConnectClient::weatherUpdated, mapWidget, &MapWidget::weatherUpdated);
   connect(connectClient, &ConnectClient::weatherUpdated, mapWidget, &MapWidget::updateTooltip);
   connect(connectClient, &ConnectClient::weatherUpdated, infoController, &InfoController::updateAirport);
@@ -1397,11 +1428,17 @@ const ElevationModel *MainWindow::getElevationModel()
   return mapWidget->model()->elevationModel();
 }
 
-/* Called after each query */
-void MainWindow::resultTruncated(int truncatedTo)
+/* Called after each map paint event if objects were omitted */
+void MainWindow::resultTruncated(int numOmitted, const QString& thinnedTypes)
 {
-  if(truncatedTo > 0)
-    messageLabel->setText(tr("<b style=\"color: red;\">Too many objects.</b>"));
+  if(numOmitted > 0)
+  {
+    if(thinnedTypes.isEmpty())
+      messageLabel->setText(tr("<b style=\"color: red;\">Too many objects.</b>"));
+    else
+      messageLabel->setText(tr("<b style=\"color: red;\">Too many objects.</b> Not shown: %1 %2.").
+                            arg(numOmitted).arg(thinnedTypes));
+  }
 }
 
 void MainWindow::distanceChanged()
@@ -2157,24 +2194,28 @@ void MainWindow::routeSelectionChanged(int selected, int total)
 void MainWindow::searchSelectionChanged(const SearchBaseTable *source, int selected, int visible, int total)
 {
   QString selectionLabelText = tr("%1 of %2 %3 selected, %4 visible.%5");
+
+  // Total is a lower limit until the delayed count query is done
+  QString totalText = source->isTotalRowCountValid() ? QString::number(total) : tr("at least %1").arg(total);
+
   QString type;
   if(source->getTabIndex() == si::SEARCH_AIRPORT)
   {
     type = tr("Airports");
     ui->labelAirportSearchStatus->setText(selectionLabelText.
-                                          arg(selected).arg(total).arg(type).arg(visible).arg(QString()));
+                                          arg(selected).arg(totalText).arg(type).arg(visible).arg(QString()));
   }
   else if(source->getTabIndex() == si::SEARCH_NAV)
   {
     type = tr("Navaids");
     ui->labelNavSearchStatus->setText(selectionLabelText.
-                                      arg(selected).arg(total).arg(type).arg(visible).arg(QString()));
+                                      arg(selected).arg(totalText).arg(type).arg(visible).arg(QString()));
   }
   else if(source->getTabIndex() == si::SEARCH_USER)
   {
     type = tr("Userpoints");
     ui->labelUserdata->setText(selectionLabelText.
-                               arg(selected).arg(total).arg(type).arg(visible).arg(QString()));
+                               arg(selected).arg(totalText).arg(type).arg(visible).arg(QString()));
   }
   else if(source->getTabIndex() == si::SEARCH_ONLINE_CLIENT)
   {
@@ -2182,7 +2223,7 @@ void MainWindow::searchSelectionChanged(const SearchBaseTable *source, int selec
     QString lastUpdate = tr(" Last Update: %1").
                          arg(NavApp::getOnlinedataController()->getLastUpdateTime().toString(Qt::SystemLocaleShortDate));
     ui->labelOnlineClientSearchStatus->setText(selectionLabelText.
-                                               arg(selected).arg(total).arg(type).arg(visible).
+                                               arg(selected).arg(totalText).arg(type).arg(visible).
                                                arg(lastUpdate));
   }
   else if(source->getTabIndex() == si::SEARCH_ONLINE_CENTER)
@@ -2191,7 +2232,7 @@ void MainWindow::searchSelectionChanged(const SearchBaseTable *source, int selec
     QString lastUpdate = tr(" Last Update: %1").
                          arg(NavApp::getOnlinedataController()->getLastUpdateTime().toString(Qt::SystemLocaleShortDate));
     ui->labelOnlineCenterSearchStatus->setText(selectionLabelText.
-                                               arg(selected).arg(total).arg(type).arg(visible).
+                                               arg(selected).arg(totalText).arg(type).arg(visible).
                                                arg(lastUpdate));
   }
 
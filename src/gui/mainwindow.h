@@ -151,7 +151,7 @@ public:
   /* Render status from marble widget */
   void renderStatusChanged(Marble::RenderStatus status);
 
-  void resultTruncated(int truncatedTo);
+  void resultTruncated(int numOmitted, const QString& thinnedTypes);
 
   void setDatabaseErased(bool value)
   {
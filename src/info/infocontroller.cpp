@@ -336,7 +336,7 @@ void InfoController::updateProgress()
   {
     // ok - scrollbars not pressed
     html.clear();
-    infoBuilder->aircraftProgressText(lastSimData.getUserAircraftConst(), html, NavApp::getRouteConst(),
+    infoBuilder->aircraftProgressText(lastSimData->getUserAircraftConst(), html, NavApp::getRouteConst(),
                                       true /* show more/less switch */, lessAircraftProgress);
     atools::gui::util::updateTextEdit(ui->textBrowserAircraftProgressInfo, html.getHtml(),
                                       false /* scroll to top*/, true /* keep selection */);
@@ -838,14 +838,14 @@ void InfoController::updateUserAircraftText()
   if(NavApp::isConnected())
 #endif
   {
-    if(lastSimData.getUserAircraftConst().getPosition().isValid())
+    if(lastSimData->getUserAircraftConst().getPosition().isValid())
     {
       if(atools::gui::util::canTextEditUpdate(ui->textBrowserAircraftInfo))
       {
         // ok - scrollbars not pressed
         HtmlBuilder html(true /* has background color */);
-        infoBuilder->aircraftText(lastSimData.getUserAircraftConst(), html);
-        infoBuilder->aircraftTextWeightAndFuel(lastSimData.getUserAircraftConst(), html);
+        infoBuilder->aircraftText(lastSimData->getUserAircraftConst(), html);
+        infoBuilder->aircraftTextWeightAndFuel(lastSimData->getUserAircraftConst(), html);
         atools::gui::util::updateTextEdit(ui->textBrowserAircraftInfo, html.getHtml(),
                                           false /* scroll to top*/, true /* keep selection */);
       }
@@ -866,13 +866,13 @@ void InfoController::updateAircraftProgressText()
   if(NavApp::isConnected())
 #endif
   {
-    if(lastSimData.getUserAircraftConst().getPosition().isValid())
+    if(lastSimData->getUserAircraftConst().getPosition().isValid())
     {
       if(atools::gui::util::canTextEditUpdate(ui->textBrowserAircraftProgressInfo))
       {
         // ok - scrollbars not pressed
         HtmlBuilder html(true /* has background color */);
-        infoBuilder->aircraftProgressText(lastSimData.getUserAircraftConst(), html, NavApp::getRouteConst(),
+        infoBuilder->aircraftProgressText(lastSimData->getUserAircraftConst(), html, NavApp::getRouteConst(),
                                           true /* show more/less switch */, lessAircraftProgress);
         atools::gui::util::updateTextEdit(ui->textBrowserAircraftProgressInfo, html.getHtml(),
                                           false /* scroll to top*/, true /* keep selection */);
@@ -894,7 +894,7 @@ void InfoController::updateAiAircraftText()
   if(NavApp::isConnected())
 #endif
   {
-    if(lastSimData.getUserAircraftConst().getPosition().isValid())
+    if(lastSimData->getUserAircraftConst().getPosition().isValid())
     {
       if(atools::gui::util::canTextEditUpdate(ui->textBrowserAircraftAiInfo))
       {
@@ -906,7 +906,7 @@ void InfoController::updateAiAircraftText()
           int num = 1;
           for(const SimConnectAircraft& aircraft : currentSearchResult.aiAircraft)
           {
-            infoBuilder->aircraftText(aircraft, html, num, lastSimData.getAiAircraftConst().size());
+            infoBuilder->aircraftText(aircraft, html, num, lastSimData->getAiAircraftConst().size());
             infoBuilder->aircraftProgressText(aircraft, html, Route(),
                                               false /* show more/less switch */, false /* true if less info mode */);
             num++;
@@ -917,7 +917,7 @@ void InfoController::updateAiAircraftText()
         }
         else
         {
-          int numAi = lastSimData.getAiAircraftConst().size();
+          int numAi = lastSimData->getAiAircraftConst().size();
           QString text;
 
           if(!(NavApp::getShownMapFeatures() & map::AIRCRAFT_AI))
@@ -938,47 +938,43 @@ void InfoController::updateAiAircraftText()
     ui->textBrowserAircraftAiInfo->clear();
 }
 
-void InfoController::simDataChanged(atools::fs::sc::SimConnectData data)
+void InfoController::simDataChanged(const SimConnectDataPtr& data)
 {
   if(databaseLoadStatus)
     return;
 
   Ui::MainWindow *ui = NavApp::getMainUi();
 
-  if(atools::almostNotEqual(QDateTime::currentDateTime().toMSecsSinceEpoch(),
-                            lastSimUpdate, static_cast<qint64>(MIN_SIM_UPDATE_TIME_MS)))
-  {
-    // Last update was more than 500 ms ago
-    updateAiAirports(data);
+  updateAiAirports(*data);
 
-    lastSimData = data;
-    if(data.getUserAircraftConst().isValid() && ui->dockWidgetAircraft->isVisible())
-    {
-      if(ui->tabWidgetAircraft->currentIndex() == ic::AIRCRAFT_USER)
-        updateUserAircraftText();
+  lastSimData = data;
+  if(data->getUserAircraftConst().isValid() && ui->dockWidgetAircraft->isVisible())
+  {
+    if(ui->tabWidgetAircraft->currentIndex() == ic::AIRCRAFT_USER)
+      updateUserAircraftText();
 
-      if(ui->tabWidgetAircraft->currentIndex() == ic::AIRCRAFT_USER_PROGRESS)
-        updateAircraftProgressText();
+    if(ui->tabWidgetAircraft->currentIndex() == ic::AIRCRAFT_USER_PROGRESS)
+      updateAircraftProgressText();
 
-      if(ui->tabWidgetAircraft->currentIndex() == ic::AIRCRAFT_AI)
-        updateAiAircraftText();
-    }
-    lastSimUpdate = QDateTime::currentDateTime().toMSecsSinceEpoch();
+    if(ui->tabWidgetAircraft->currentIndex() == ic::AIRCRAFT_AI)
+      updateAiAircraftText();
   }
+}
 
-  if(atools::almostNotEqual(QDateTime::currentDateTime().toMSecsSinceEpoch(),
-                            lastSimBearingUpdate, static_cast<qint64>(MIN_SIM_UPDATE_BEARING_TIME_MS)))
+void InfoController::simDataChangedBearing(const SimConnectDataPtr& data)
+{
+  if(databaseLoadStatus)
+    return;
+
+  Ui::MainWindow *ui = NavApp::getMainUi();
+
+  if(data->getUserAircraftConst().isValid() && ui->dockWidgetInformation->isVisible())
   {
-    // Last update was more than a second ago
-    if(data.getUserAircraftConst().isValid() && ui->dockWidgetInformation->isVisible())
-    {
-      if(ui->tabWidgetInformation->currentIndex() == ic::INFO_AIRPORT)
-        updateAirportInternal(false /* new */, true /* bearing change*/, false /* scroll to top */);
+    if(ui->tabWidgetInformation->currentIndex() == ic::INFO_AIRPORT)
+      updateAirportInternal(false /* new */, true /* bearing change*/, false /* scroll to top */);
 
-      if(ui->tabWidgetInformation->currentIndex() == ic::INFO_NAVAID)
-        updateNavaidInternal(currentSearchResult, true /* bearing changed */, false /* scroll to top */);
-    }
-    lastSimBearingUpdate = QDateTime::currentDateTime().toMSecsSinceEpoch();
+    if(ui->tabWidgetInformation->currentIndex() == ic::INFO_NAVAID)
+      updateNavaidInternal(currentSearchResult, true /* bearing changed */, false /* scroll to top */);
   }
 }
 
@@ -1017,8 +1013,7 @@ void InfoController::connectedToSimulator()
 void InfoController::disconnectedFromSimulator()
 {
   qDebug() << Q_FUNC_INFO;
-  lastSimData = atools::fs::sc::SimConnectData();
-  lastSimUpdate = 0;
+  lastSimData = simdata::emptySnapshot();
   updateAircraftInfo();
 }
 
@@ -18,6 +18,7 @@
 #ifndef LITTLENAVMAP_INFOCONTROLLER_H
 #define LITTLENAVMAP_INFOCONTROLLER_H
 
+#include "connect/simdatasnapshot.h"
 #include "fs/sc/simconnectdata.h"
 #include "common/maptypes.h"
 
@@ -95,8 +96,18 @@ public:
   void preDatabaseLoad();
   void postDatabaseLoad();
 
-  /* Update aircraft and aircraft progress tab */
-  void simDataChanged(atools::fs::sc::SimConnectData data);
+  /* Do not update aircraft progress more than every 0.5 seconds. Used by the sim data dispatcher. */
+  static Q_DECL_CONSTEXPR int MIN_SIM_UPDATE_TIME_MS = 500;
+
+  /* Bearing update in information window time limit */
+  static Q_DECL_CONSTEXPR int MIN_SIM_UPDATE_BEARING_TIME_MS = 1000;
+
+  /* Update aircraft and aircraft progress tab. Called at most every MIN_SIM_UPDATE_TIME_MS. */
+  void simDataChanged(const SimConnectDataPtr& data);
+
+  /* Update bearing in airport and navaid tab. Called at most every MIN_SIM_UPDATE_BEARING_TIME_MS. */
+  void simDataChangedBearing(const SimConnectDataPtr& data);
+
   void connectedToSimulator();
   void disconnectedFromSimulator();
 
@@ -114,12 +125,6 @@ signals:
   void showRect(const atools::geo::Rect& rect, bool doubleClick);
 
 private:
-  /* Do not update aircraft progress more than every 0.5 seconds */
-  static Q_DECL_CONSTEXPR int MIN_SIM_UPDATE_TIME_MS = 500;
-
-  /* Bearing update in information window time limit */
-  static Q_DECL_CONSTEXPR int MIN_SIM_UPDATE_BEARING_TIME_MS = 1000;
-
   void updateAirportInternal(bool newAirport, bool bearingChange, bool scrollToTop);
   bool updateNavaidInternal(const map::MapSearchResult& result, bool bearingChanged, bool scrollToTop);
 
@@ -144,9 +149,7 @@ private:
   void visibilityChangedInfo(bool visible);
 
   bool databaseLoadStatus = false;
-  atools::fs::sc::SimConnectData lastSimData;
-  qint64 lastSimUpdate = 0;
-  qint64 lastSimBearingUpdate = 0;
+  SimConnectDataPtr lastSimData = simdata::emptySnapshot();
 
   /* Airport and navaids that are currently shown in the tabs */
   map::MapSearchResult currentSearchResult;
@@ -0,0 +1,85 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "mapgui/mapdetailgovernor.h"
+
+#include <QDebug>
+
+/* Number of frames used for the moving average */
+const static int NUM_FRAMES_AVERAGE = 5;
+
+/* Minimum number of frames before reducing details again after a change */
+const static int MIN_FRAMES_REDUCE = 3;
+
+/* Minimum number of frames before increasing details again after a change */
+const static int MIN_FRAMES_INCREASE = 20;
+
+/* Increase details only if the average is below this fraction of the target time */
+const static double INCREASE_THRESHOLD = 0.5;
+
+MapDetailGovernor::MapDetailGovernor()
+{
+  frameTimes.reserve(NUM_FRAMES_AVERAGE);
+}
+
+bool MapDetailGovernor::addFrameTime(qint64 milliseconds)
+{
+  // Fill the ring buffer
+  if(frameTimes.size() < NUM_FRAMES_AVERAGE)
+    frameTimes.append(milliseconds);
+  else
+    frameTimes[frameTimeIndex] = milliseconds;
+  frameTimeIndex = (frameTimeIndex + 1) % NUM_FRAMES_AVERAGE;
+  framesSinceChange++;
+
+  qint64 sum = 0L;
+  for(qint64 time : frameTimes)
+    sum += time;
+  double average = static_cast<double>(sum) / frameTimes.size();
+
+  int oldLevel = level;
+  if(average > targetFrameTimeMs && level < MAX_LEVEL && framesSinceChange >= MIN_FRAMES_REDUCE)
+    changeLevel(level + 1);
+  else if(average < targetFrameTimeMs * INCREASE_THRESHOLD && level > 0 &&
+          framesSinceChange >= MIN_FRAMES_INCREASE)
+    changeLevel(level - 1);
+
+  if(oldLevel != level)
+  {
+    qDebug() << Q_FUNC_INFO << "Map detail reduction level changed from" << oldLevel << "to" << level
+             << "average frame time" << average << "ms";
+    return true;
+  }
+  return false;
+}
+
+bool MapDetailGovernor::reset()
+{
+  int oldLevel = level;
+  changeLevel(0);
+  return oldLevel != level;
+}
+
+void MapDetailGovernor::changeLevel(int newLevel)
+{
+  level = newLevel;
+  framesSinceChange = 0;
+
+  // Times of the old level are not meaningful anymore
+  frameTimes.clear();
+  frameTimeIndex = 0;
+}
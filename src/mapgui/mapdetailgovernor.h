@@ -0,0 +1,96 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_MAPDETAILGOVERNOR_H
+#define LITTLENAVMAP_MAPDETAILGOVERNOR_H
+
+#include <QVector>
+
+/*
+ * Measures the time needed to paint the map and lowers or raises the map details step by step
+ * to keep a target frame time.
+ *
+ * Reduction levels are applied cumulative:
+ * 1. No airspace fill
+ * 2. Labels only for the closest AI and online aircraft
+ * 3. Detail factor one step lower
+ * 4. Detail factor two steps lower
+ * 5. Reduced details as used while scrolling
+ *
+ * A level is raised quickly if frames are too slow and lowered slowly if frames are well below the target
+ * to avoid toggling between levels.
+ */
+class MapDetailGovernor
+{
+public:
+  MapDetailGovernor();
+
+  /* Add the time needed for a completely painted frame. Returns true if the reduction level has changed. */
+  bool addFrameTime(qint64 milliseconds);
+
+  /* Go back to full details and clear all collected times. Returns true if the level has changed. */
+  bool reset();
+
+  void setTargetFrameTime(int milliseconds)
+  {
+    targetFrameTimeMs = milliseconds;
+  }
+
+  /* Level from 0 (full details) to MAX_LEVEL */
+  int getLevel() const
+  {
+    return level;
+  }
+
+  bool isAirspaceFill() const
+  {
+    return level < 1;
+  }
+
+  bool isAiLabelsClosestOnly() const
+  {
+    return level >= 2;
+  }
+
+  /* Value to subtract from the detail factor */
+  int getDetailFactorReduction() const
+  {
+    return level >= 4 ? 2 : (level >= 3 ? 1 : 0);
+  }
+
+  bool isDrawFast() const
+  {
+    return level >= 5;
+  }
+
+  static Q_DECL_CONSTEXPR int MAX_LEVEL = 5;
+
+private:
+  void changeLevel(int newLevel);
+
+  /* Times of the last frames used for the moving average */
+  QVector<qint64> frameTimes;
+  int frameTimeIndex = 0;
+
+  /* Frames painted since the last level change */
+  int framesSinceChange = 0;
+
+  int level = 0;
+  int targetFrameTimeMs = 50;
+};
+
+#endif // LITTLENAVMAP_MAPDETAILGOVERNOR_H
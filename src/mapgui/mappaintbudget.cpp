@@ -0,0 +1,84 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "mapgui/mappaintbudget.h"
+
+#include <QStringList>
+
+#include <algorithm>
+#include <limits>
+
+MapPaintBudget::MapPaintBudget()
+{
+  clear();
+}
+
+void MapPaintBudget::clear()
+{
+  candidates.fill(0);
+  used.fill(0);
+  quotas.fill(std::numeric_limits<int>::max());
+}
+
+void MapPaintBudget::addCandidates(Type type, int number)
+{
+  candidates[type] += number;
+}
+
+void MapPaintBudget::plan(int maxObjects)
+{
+  used.fill(0);
+
+  int remaining = std::max(maxObjects, 0);
+  for(int i = 0; i < NUM_TYPES; i++)
+  {
+    // Give the more important types all they need first
+    quotas[i] = std::min(candidates[i], remaining);
+    remaining -= quotas[i];
+  }
+}
+
+int MapPaintBudget::getNumThinned() const
+{
+  int num = 0;
+  for(int i = 0; i < NUM_TYPES; i++)
+  {
+    if(candidates[i] > quotas[i])
+      num += candidates[i] - quotas[i];
+  }
+  return num;
+}
+
+QString MapPaintBudget::getThinnedText() const
+{
+  static const std::array<const char *, NUM_TYPES> NAMES =
+  {
+    {
+      QT_TR_NOOP("airports"), QT_TR_NOOP("VOR"), QT_TR_NOOP("NDB"), QT_TR_NOOP("ILS"),
+      QT_TR_NOOP("userpoints"), QT_TR_NOOP("airspaces"), QT_TR_NOOP("markers"), QT_TR_NOOP("airways"),
+      QT_TR_NOOP("waypoints")
+    }
+  };
+
+  QStringList types;
+  for(int i = 0; i < NUM_TYPES; i++)
+  {
+    if(candidates[i] > quotas[i])
+      types.append(tr(NAMES[static_cast<size_t>(i)]));
+  }
+  return types.join(tr(", "));
+}
@@ -0,0 +1,91 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_MAPPAINTBUDGET_H
+#define LITTLENAVMAP_MAPPAINTBUDGET_H
+
+#include <QCoreApplication>
+
+#include <array>
+
+/*
+ * Distributes the maximum number of drawn map objects to object types by priority.
+ *
+ * Painters first add the number of objects they would draw (candidates). The plan then assigns
+ * a quota to each type in order of priority. Painters draw only the most important objects of a type
+ * within its quota instead of stopping when the total number of objects is exceeded.
+ *
+ * Quotas are unlimited until a plan is made. Each type is only counted by one thread at a time.
+ */
+class MapPaintBudget
+{
+  Q_DECLARE_TR_FUNCTIONS(MapPaintBudget)
+
+public:
+  /* Object types ordered by priority. Highest priority first. */
+  enum Type
+  {
+    AIRPORT,
+    VOR,
+    NDB,
+    ILS,
+    USERPOINT,
+    AIRSPACE,
+    MARKER,
+    AIRWAY,
+    WAYPOINT,
+    NUM_TYPES
+  };
+
+  MapPaintBudget();
+
+  /* Remove plan and all counts */
+  void clear();
+
+  /* Add number of objects that would be drawn for a type */
+  void addCandidates(Type type, int number);
+
+  /* Distribute number of objects to all types by priority */
+  void plan(int maxObjects);
+
+  /* Maximum number of objects that can be drawn for the type */
+  int getQuota(Type type) const
+  {
+    return quotas[type];
+  }
+
+  /* Count a drawn object. Returns true if the quota for the type is exceeded. */
+  bool take(Type type)
+  {
+    if(used[type] >= quotas[type])
+      return true;
+
+    used[type]++;
+    return false;
+  }
+
+  /* Total number of objects omitted by the plan */
+  int getNumThinned() const;
+
+  /* Comma separated list of object types which were thinned out like "waypoints, airways" */
+  QString getThinnedText() const;
+
+private:
+  std::array<int, NUM_TYPES> candidates, quotas, used;
+};
+
+#endif // LITTLENAVMAP_MAPPAINTBUDGET_H
@@ -51,6 +51,11 @@ MapPainter::~MapPainter()
   delete symbolPainter;
 }
 
+void MapPainter::countCandidates(PaintContext *context)
+{
+  Q_UNUSED(context);
+}
+
 void MapPainter::paintCircle(GeoPainter *painter, const Pos& centerPos, float radiusNm, bool fast,
                              int& xtext, int& ytext)
 {
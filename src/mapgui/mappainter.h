@@ -21,6 +21,7 @@
 #include "common/coordinateconverter.h"
 #include "common/mapflags.h"
 #include "options/optiondata.h"
+#include "mapgui/mappaintbudget.h"
 #include "geo/rect.h"
 
 #include <marble/MarbleWidget.h>
@@ -59,6 +60,8 @@ struct PaintContext
   float zoomDistanceMeter;
   bool drawFast; /* true if reduced details should be used */
   bool lazyUpdate; /* postpone reloading until map is still */
+  bool airspaceFill = true; /* false if airspaces should be drawn as outlines only */
+  bool aiLabelsClosestOnly = false; /* Draw labels only for the closest AI and online aircraft */
   map::MapObjectTypes objectTypes; /* Object types that should be drawn */
   map::MapObjectDisplayTypes objectDisplayTypes; /* Object types that should be drawn */
   map::MapAirspaceFilter airspaceFilterByLayer; /* Airspaces */
@@ -94,8 +97,14 @@ struct PaintContext
 
   // Needs to be larger than number of highest level airports
   static Q_DECL_CONSTEXPR int MAX_OBJECT_COUNT = 4000;
+
+  // Number of objects not distributed by the budget plan. Used for highlights and others.
+  static Q_DECL_CONSTEXPR int RESERVED_OBJECT_COUNT = 100;
   int objectCount = 0;
 
+  /* Distributes objects to types by priority. null if no plan is used. */
+  MapPaintBudget *budget = nullptr;
+
   /* Increase drawn object count and return true if exceeded */
   bool objCount()
   {
@@ -103,6 +112,28 @@ struct PaintContext
     return objectCount > MAX_OBJECT_COUNT;
   }
 
+  /* Increase drawn object count and return true if the quota for the type or the total number is exceeded */
+  bool objCount(MapPaintBudget::Type type)
+  {
+    if(budget != nullptr && budget->take(type))
+      return true;
+
+    return objCount();
+  }
+
+  /* Maximum number of objects to draw for the type */
+  int objQuota(MapPaintBudget::Type type) const
+  {
+    return budget != nullptr ? budget->getQuota(type) : MAX_OBJECT_COUNT;
+  }
+
+  /* Add number of objects which would be drawn for the type to the plan */
+  void objCandidates(MapPaintBudget::Type type, int number)
+  {
+    if(budget != nullptr)
+      budget->addCandidates(type, number);
+  }
+
   bool isOverflow()
   {
     return objectCount > MAX_OBJECT_COUNT;
@@ -168,6 +199,10 @@ public:
 
   virtual void render(PaintContext *context) = 0;
 
+  /* Count objects that would be drawn by render and add them to the budget plan in the context.
+   * Default does nothing for painters which do not use the plan. */
+  virtual void countCandidates(PaintContext *context);
+
 protected:
   /* Draw a circle and return text placement hints (xtext and ytext). Number of points used
    * for the circle depends on the zoom distance */
@@ -67,13 +67,9 @@ MapPainterAirport::~MapPainterAirport()
 {
 }
 
-void MapPainterAirport::render(PaintContext *context)
+QSet<int> MapPainterAirport::routeAirportIds(const PaintContext *context) const
 {
-  typedef std::pair<const MapAirport *, QPointF> PaintAirportType;
-
-  // Get all airports from the route and add them to the map
-  QSet<int> routeAirportIdMap; // Collect all airports from route and bounding rectangle
-
+  QSet<int> routeAirportIdMap;
   if(context->objectTypes.testFlag(map::FLIGHTPLAN))
   {
     for(const RouteLeg& routeLeg : *route)
@@ -82,14 +78,16 @@ void MapPainterAirport::render(PaintContext *context)
         routeAirportIdMap.insert(routeLeg.getAirport().id);
     }
   }
+  return routeAirportIdMap;
+}
 
+void MapPainterAirport::collectVisibleAirports(const PaintContext *context, const QSet<int>& routeAirportIdMap,
+                                               QList<PaintAirportType>& airports)
+{
   if((!context->objectTypes.testFlag(map::AIRPORT) || !context->mapLayer->isAirport()) &&
      (!context->mapLayerEffective->isAirportDiagramRunway()) && routeAirportIdMap.isEmpty())
     return;
 
-  atools::util::PainterContextSaver saver(context->painter);
-  Q_UNUSED(saver);
-
   // Get airports from cache/database for the bounding rectangle and add them to the map
   const GeoDataLatLonAltBox& curBox = context->viewport->viewLatLonAltBox();
   const QList<MapAirport> *airportCache = nullptr;
@@ -99,7 +97,6 @@ void MapPainterAirport::render(PaintContext *context)
     airportCache = mapQuery->getAirports(curBox, context->mapLayer, context->lazyUpdate);
 
   // Collect all airports that are visible
-  QList<PaintAirportType> visibleAirports;
   for(const MapAirport& airport : *airportCache)
   {
     // Either part of the route or enabled in the actions/menus/toolbar
@@ -119,13 +116,53 @@ void MapPainterAirport::render(PaintContext *context)
           // Check bounding rect for visibility if relevant - not for point symbols
           visible = airport.bounding.overlaps(context->viewportRect);
 
-        airport.bounding.overlaps(context->viewportRect);
-
         if(visible)
-          visibleAirports.append(std::make_pair(&airport, QPointF(x, y)));
+          airports.append(std::make_pair(&airport, QPointF(x, y)));
       }
     }
   }
+}
+
+void MapPainterAirport::countCandidates(PaintContext *context)
+{
+  // Collect airports with screen positions once - render uses them for this paint event
+  candidateRouteAirportIds = routeAirportIds(context);
+  candidateAirports.clear();
+  collectVisibleAirports(context, candidateRouteAirportIds, candidateAirports);
+  airportsCollected = true;
+
+  // Route airports are drawn by the route painter
+  int num = 0;
+  for(const PaintAirportType& airport : candidateAirports)
+  {
+    if(!candidateRouteAirportIds.contains(airport.first->id))
+      num++;
+  }
+  context->objCandidates(MapPaintBudget::AIRPORT, num);
+}
+
+void MapPainterAirport::render(PaintContext *context)
+{
+  if(!airportsCollected)
+  {
+    // Not counted for this paint event - get all airports from the route and the visible ones
+    candidateRouteAirportIds = routeAirportIds(context);
+    candidateAirports.clear();
+    collectVisibleAirports(context, candidateRouteAirportIds, candidateAirports);
+  }
+
+  // Take the lists to avoid keeping pointers into the cache after painting
+  QSet<int> routeAirportIdMap;
+  QList<PaintAirportType> visibleAirports;
+  routeAirportIdMap.swap(candidateRouteAirportIds);
+  visibleAirports.swap(candidateAirports);
+  airportsCollected = false;
+
+  if(visibleAirports.isEmpty())
+    return;
+
+  atools::util::PainterContextSaver saver(context->painter);
+  Q_UNUSED(saver);
 
   const OptionData& od = OptionData::instance();
   std::sort(visibleAirports.begin(), visibleAirports.end(),
@@ -160,6 +197,26 @@ void MapPainterAirport::render(PaintContext *context)
       return ap1->emptyDraw(od) > ap2->emptyDraw(od);
   });
 
+  // List is sorted by importance with the most important airports at the end.
+  // Remove the least important ones if the budget does not allow to draw all. Keep route airports.
+  int numRemove = -context->objQuota(MapPaintBudget::AIRPORT);
+  for(const PaintAirportType& airport : visibleAirports)
+  {
+    if(!routeAirportIdMap.contains(airport.first->id))
+      numRemove++;
+  }
+
+  for(auto it = visibleAirports.begin(); it != visibleAirports.end() && numRemove > 0;)
+  {
+    if(!routeAirportIdMap.contains(it->first->id))
+    {
+      it = visibleAirports.erase(it);
+      numRemove--;
+    }
+    else
+      ++it;
+  }
+
   if(context->mapLayerEffective->isAirportDiagramRunway() && context->flags2 & opts::MAP_AIRPORT_BOUNDARY)
   {
     // In diagram mode draw background first to avoid overwriting other airports
@@ -1072,7 +1129,7 @@ void MapPainterAirport::drawAirportSymbol(PaintContext *context, const map::MapA
      ap.waterOnly() || ap.longestRunwayLength < RUNWAY_OVERVIEW_MIN_LENGTH_FEET ||
      context->mapLayerEffective->isAirportDiagramRunway())
   {
-    if(context->objCount())
+    if(context->objCount(MapPaintBudget::AIRPORT))
       return;
 
     int size = context->sz(context->symbolSizeAirport, context->mapLayerEffective->getAirportSymbolSize());
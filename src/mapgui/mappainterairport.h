@@ -22,6 +22,8 @@
 
 #include "fs/common/xpgeometry.h"
 
+#include <QSet>
+
 class SymbolPainter;
 
 namespace map {
@@ -57,8 +59,24 @@ public:
   virtual ~MapPainterAirport() override;
 
   virtual void render(PaintContext *context) override;
+  virtual void countCandidates(PaintContext *context) override;
 
 private:
+  typedef std::pair<const map::MapAirport *, QPointF> PaintAirportType;
+
+  /* Ids of all airports in the flight plan if shown */
+  QSet<int> routeAirportIds(const PaintContext *context) const;
+
+  /* Add all enabled airports or route airports with their screen position to the list which are visible */
+  void collectVisibleAirports(const PaintContext *context, const QSet<int>& routeAirportIdMap,
+                              QList<PaintAirportType>& airports);
+
+  /* Route airport ids and visible airports with screen positions. Filled by countCandidates() and used by the
+   * following render() call to avoid a second projection. */
+  QSet<int> candidateRouteAirportIds;
+  QList<PaintAirportType> candidateAirports;
+  bool airportsCollected = false;
+
   void drawAirportSymbol(PaintContext *context, const map::MapAirport& ap, float x, float y);
   void drawAirportWeather(PaintContext *context, const atools::fs::weather::Metar& metar,
                           float x, float y);
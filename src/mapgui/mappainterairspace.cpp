@@ -48,12 +48,45 @@ MapPainterAirspace::~MapPainterAirspace()
 
 void MapPainterAirspace::render(PaintContext *context)
 {
+  // Paint directly from the caches in the main thread - no need to copy
+  QList<const MapAirspace *> airspaces = visibleAirspaces(context);
+
+  if(!airspaces.isEmpty())
+  {
+    Marble::GeoPainter *painter = context->painter;
+    atools::util::PainterContextSaver saver(painter);
+    Q_UNUSED(saver);
+
+    painter->setBackgroundMode(Qt::TransparentMode);
+
+    for(const MapAirspace *airspace : airspaces)
+    {
+      if(context->objCount(MapPaintBudget::AIRSPACE))
+        return;
+
+      painter->setPen(mapcolors::penForAirspace(*airspace));
+
+      if(!context->drawFast && context->airspaceFill)
+        painter->setBrush(mapcolors::colorForAirspaceFill(*airspace));
+
+      const LineString *lines =
+        (airspace->online ? airspaceQueryOnline : airspaceQuery)->getAirspaceGeometry(airspace->id);
+      if(lines != nullptr)
+        drawAirspace(painter, *lines);
+    }
+  }
+}
+
+QList<const MapAirspace *> MapPainterAirspace::visibleAirspaces(const PaintContext *context)
+{
+  QList<const MapAirspace *> visibleList;
+
   if(!context->mapLayer->isAirspace() ||
      !(context->objectTypes.testFlag(map::AIRSPACE) || context->objectTypes.testFlag(map::AIRSPACE_ONLINE)))
-    return;
+    return visibleList;
 
   if(context->mapLayerEffective->isAirportDiagram())
-    return;
+    return visibleList;
 
   // Get online and offline airspace and merge then into one list =============
   const GeoDataLatLonAltBox& curBox = context->viewport->viewLatLonAltBox();
@@ -87,7 +120,48 @@ void MapPainterAirspace::render(PaintContext *context)
     }
   }
 
-  if(!airspaces.isEmpty())
+  for(const MapAirspace *airspace : airspaces)
+  {
+    if(airspace->type & context->airspaceFilterByLayer.types && context->viewportRect.overlaps(airspace->bounding))
+      visibleList.append(airspace);
+  }
+  return visibleList;
+}
+
+void MapPainterAirspace::countCandidates(PaintContext *context)
+{
+  context->objCandidates(MapPaintBudget::AIRSPACE, visibleAirspaces(context).size());
+}
+
+void MapPainterAirspace::prepare(const PaintContext *context)
+{
+  airspacePaintList.clear();
+
+  // Number of objects that can be drawn by the budget plan
+  int maxObjects = context->objQuota(MapPaintBudget::AIRSPACE);
+
+  for(const MapAirspace *airspace : visibleAirspaces(context))
+  {
+    if(airspacePaintList.size() >= maxObjects)
+      break;
+
+    // Copy geometry and colors since the cache entries might be removed while painting in a thread
+    AirspacePaint airspacePaint;
+    airspacePaint.pen = mapcolors::penForAirspace(*airspace);
+    airspacePaint.fillColor = mapcolors::colorForAirspaceFill(*airspace);
+
+    const LineString *lines =
+      (airspace->online ? airspaceQueryOnline : airspaceQuery)->getAirspaceGeometry(airspace->id);
+    if(lines != nullptr)
+      airspacePaint.lines = *lines;
+
+    airspacePaintList.append(airspacePaint);
+  }
+}
+
+void MapPainterAirspace::paint(PaintContext *context)
+{
+  if(!airspacePaintList.isEmpty())
   {
     Marble::GeoPainter *painter = context->painter;
     atools::util::PainterContextSaver saver(painter);
@@ -95,34 +169,28 @@ void MapPainterAirspace::render(PaintContext *context)
 
     painter->setBackgroundMode(Qt::TransparentMode);
 
-    for(const MapAirspace *airspace : airspaces)
+    for(const AirspacePaint& airspacePaint : airspacePaintList)
     {
-      if(!(airspace->type & context->airspaceFilterByLayer.types))
-        continue;
-
-      if(context->viewportRect.overlaps(airspace->bounding))
-      {
-        if(context->objCount())
-          return;
-
-        // qDebug() << airspace.getId() << airspace.name;
+      if(context->objCount(MapPaintBudget::AIRSPACE))
+        return;
 
-        Marble::GeoDataLinearRing linearRing;
-        linearRing.setTessellate(true);
+      painter->setPen(airspacePaint.pen);
 
-        painter->setPen(mapcolors::penForAirspace(*airspace));
+      if(!context->drawFast && context->airspaceFill)
+        painter->setBrush(airspacePaint.fillColor);
 
-        if(!context->drawFast)
-          painter->setBrush(mapcolors::colorForAirspaceFill(*airspace));
+      drawAirspace(painter, airspacePaint.lines);
+    }
+  }
+}
 
-        const LineString *lines =
-          (airspace->online ? airspaceQueryOnline : airspaceQuery)->getAirspaceGeometry(airspace->id);
+void MapPainterAirspace::drawAirspace(Marble::GeoPainter *painter, const LineString& lines)
+{
+  Marble::GeoDataLinearRing linearRing;
+  linearRing.setTessellate(true);
 
-        for(const Pos& pos : *lines)
-          linearRing.append(Marble::GeoDataCoordinates(pos.getLonX(), pos.getLatY(), 0, DEG));
+  for(const Pos& pos : lines)
+    linearRing.append(Marble::GeoDataCoordinates(pos.getLonX(), pos.getLatY(), 0, DEG));
 
-        painter->drawPolygon(linearRing);
-      }
-    }
-  }
+  painter->drawPolygon(linearRing);
 }
@@ -20,10 +20,16 @@
 
 #include "mapgui/mappainter.h"
 
+#include "geo/linestring.h"
+
 namespace Marble {
 class GeoDataLineString;
 }
 
+namespace map {
+struct MapAirspace;
+}
+
 class MapWidget;
 class Route;
 
@@ -38,9 +44,38 @@ public:
   virtual ~MapPainterAirspace();
 
   virtual void render(PaintContext *context) override;
+  virtual void countCandidates(PaintContext *context) override;
+
+  /* Collect airspaces, geometry and colors from the database and caches for painting in a thread.
+   * Has to be called in the main thread. Not needed for render() which paints from the caches. */
+  void prepare(const PaintContext *context);
+
+  /* Number of airspaces collected by prepare() */
+  int getNumPrepared() const
+  {
+    return airspacePaintList.size();
+  }
+
+  /* Paint all airspaces collected by prepare(). Accesses neither database nor caches and can be called in a
+   * separate thread if the painter in the context is used exclusively. */
+  void paint(PaintContext *context);
 
 private:
+  /* Get online and offline airspaces which are enabled and overlap the viewport */
+  QList<const map::MapAirspace *> visibleAirspaces(const PaintContext *context);
+
+  void drawAirspace(Marble::GeoPainter *painter, const atools::geo::LineString& lines);
+
+  /* Copied geometry and style of one airspace */
+  struct AirspacePaint
+  {
+    QPen pen;
+    QColor fillColor;
+    atools::geo::LineString lines;
+  };
+
   const Route *route;
+  QVector<AirspacePaint> airspacePaintList;
 };
 
 #endif // LITTLENAVMAP_MAPPAINTERAIRSPACE_H
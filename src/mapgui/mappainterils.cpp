@@ -69,7 +69,7 @@ void MapPainterIls::render(PaintContext *context)
 
         if(visible)
         {
-          if(context->objCount())
+          if(context->objCount(MapPaintBudget::ILS))
             return;
 
           drawIlsSymbol(context, ils);
@@ -79,6 +79,25 @@ void MapPainterIls::render(PaintContext *context)
   }
 }
 
+void MapPainterIls::countCandidates(PaintContext *context)
+{
+  if(!context->objectTypes.testFlag(map::ILS) || !context->mapLayer->isIls())
+    return;
+
+  const QList<MapIls> *ilsList = mapQuery->getIls(context->viewport->viewLatLonAltBox(), context->mapLayer,
+                                                  context->lazyUpdate);
+  if(ilsList != nullptr)
+  {
+    int num = 0;
+    for(const MapIls& ils : *ilsList)
+    {
+      if(ils.bounding.overlaps(context->viewportRect))
+        num++;
+    }
+    context->objCandidates(MapPaintBudget::ILS, num);
+  }
+}
+
 void MapPainterIls::drawIlsSymbol(const PaintContext *context, const map::MapIls& ils)
 {
   atools::util::PainterContextSaver saver(context->painter);
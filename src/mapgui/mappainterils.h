@@ -40,6 +40,7 @@ public:
   virtual ~MapPainterIls();
 
   virtual void render(PaintContext *context) override;
+  virtual void countCandidates(PaintContext *context) override;
 
 private:
   /* Fixed value that is used when writing the database. See atools::fs::db::IlsWriter */
@@ -28,6 +28,8 @@
 
 #include <QElapsedTimer>
 
+#include <algorithm>
+
 #include <marble/GeoDataLineString.h>
 #include <marble/GeoPainter.h>
 #include <marble/ViewportParams.h>
@@ -45,6 +47,102 @@ MapPainterNav::~MapPainterNav()
 {
 }
 
+template<typename TYPE, typename FILTER>
+QVector<MapPainterNav::ScreenNavaid<TYPE> > MapPainterNav::visibleNavaids(const QList<TYPE> *navaids, FILTER filter)
+{
+  QVector<ScreenNavaid<TYPE> > visibleList;
+  for(const TYPE& navaid : *navaids)
+  {
+    if(!filter(navaid))
+      continue;
+
+    int x, y;
+    if(wToS(navaid.position, x, y))
+      visibleList.append({&navaid, x, y});
+  }
+  return visibleList;
+}
+
+template<typename TYPE, typename MOREIMPORTANT>
+void MapPainterNav::thinNavaids(QVector<ScreenNavaid<TYPE> >& navaids, int quota, MOREIMPORTANT moreImportant)
+{
+  if(navaids.size() > quota)
+  {
+    // Move the most important ones to the front and cut off the rest
+    std::stable_sort(navaids.begin(), navaids.end(),
+                     [moreImportant](const ScreenNavaid<TYPE>& n1, const ScreenNavaid<TYPE>& n2) -> bool {
+      return moreImportant(*n1.navaid, *n2.navaid);
+    });
+    navaids.resize(std::max(quota, 0));
+  }
+}
+
+QVector<MapPainterNav::ScreenNavaid<MapWaypoint> > MapPainterNav::visibleWaypoints(const PaintContext *context,
+                                                                                 const QList<MapWaypoint> *waypoints,
+                                                                                 bool drawWaypoint)
+{
+  bool drawAirwayV = context->mapLayer->isAirwayWaypoint() && context->objectTypes.testFlag(map::AIRWAYV);
+  bool drawAirwayJ = context->mapLayer->isAirwayWaypoint() && context->objectTypes.testFlag(map::AIRWAYJ);
+
+  // If waypoints are off, airways are on and waypoint has no airways skip it
+  return visibleNavaids(waypoints, [ = ](const MapWaypoint& waypoint) -> bool {
+    return drawWaypoint || (drawAirwayV && waypoint.hasVictorAirways) || (drawAirwayJ && waypoint.hasJetAirways);
+  });
+}
+
+void MapPainterNav::collectNavaids(const PaintContext *context)
+{
+  clearNavaids();
+
+  const GeoDataLatLonAltBox& curBox = context->viewport->viewLatLonAltBox();
+  auto all = [](const auto&) -> bool {
+               return true;
+             };
+
+  bool drawAirway = context->mapLayer->isAirway() &&
+                    (context->objectTypes.testFlag(map::AIRWAYJ) ||
+                     context->objectTypes.testFlag(map::AIRWAYV));
+
+  // If airways are drawn we also have to go through waypoints
+  bool drawWaypoint = context->mapLayer->isWaypoint() && context->objectTypes.testFlag(map::WAYPOINT);
+  if(drawWaypoint || drawAirway)
+  {
+    const QList<MapWaypoint> *waypoints = mapQuery->getWaypoints(curBox, context->mapLayer, context->lazyUpdate);
+    if(waypoints != nullptr)
+      visibleWaypointList = visibleWaypoints(context, waypoints, drawWaypoint);
+  }
+
+  if(context->mapLayer->isVor() && context->objectTypes.testFlag(map::VOR))
+  {
+    const QList<MapVor> *vors = mapQuery->getVors(curBox, context->mapLayer, context->lazyUpdate);
+    if(vors != nullptr)
+      visibleVorList = visibleNavaids(vors, all);
+  }
+
+  if(context->mapLayer->isNdb() && context->objectTypes.testFlag(map::NDB))
+  {
+    const QList<MapNdb> *ndbs = mapQuery->getNdbs(curBox, context->mapLayer, context->lazyUpdate);
+    if(ndbs != nullptr)
+      visibleNdbList = visibleNavaids(ndbs, all);
+  }
+
+  if(context->mapLayer->isMarker() && context->objectTypes.testFlag(map::ILS))
+  {
+    const QList<MapMarker> *markers = mapQuery->getMarkers(curBox, context->mapLayer, context->lazyUpdate);
+    if(markers != nullptr)
+      visibleMarkerList = visibleNavaids(markers, all);
+  }
+}
+
+void MapPainterNav::clearNavaids()
+{
+  visibleWaypointList.clear();
+  visibleVorList.clear();
+  visibleNdbList.clear();
+  visibleMarkerList.clear();
+  navaidsCollected = false;
+}
+
 void MapPainterNav::render(PaintContext *context)
 {
   const GeoDataLatLonAltBox& curBox = context->viewport->viewLatLonAltBox();
@@ -52,6 +150,10 @@ void MapPainterNav::render(PaintContext *context)
   atools::util::PainterContextSaver saver(context->painter);
   Q_UNUSED(saver);
 
+  // Use navaids and screen positions from countCandidates() if called for this paint event
+  if(!navaidsCollected)
+    collectNavaids(context);
+
   // Airways -------------------------------------------------
   bool drawAirway = context->mapLayer->isAirway() &&
                     (context->objectTypes.testFlag(map::AIRWAYJ) ||
@@ -69,38 +171,55 @@ void MapPainterNav::render(PaintContext *context)
   }
 
   // Waypoints -------------------------------------------------
-  bool drawWaypoint = context->mapLayer->isWaypoint() && context->objectTypes.testFlag(map::WAYPOINT);
-  if((drawWaypoint || drawAirway) && !context->isOverflow())
-  {
-    // If airways are drawn we also have to go through waypoints
-    const QList<MapWaypoint> *waypoints = mapQuery->getWaypoints(curBox, context->mapLayer, context->lazyUpdate);
-    if(waypoints != nullptr)
-      paintWaypoints(context, waypoints, drawWaypoint, context->drawFast);
-  }
+  if(!visibleWaypointList.isEmpty() && !context->isOverflow())
+    paintWaypoints(context, visibleWaypointList, context->drawFast);
 
   // VOR -------------------------------------------------
-  if(context->mapLayer->isVor() && context->objectTypes.testFlag(map::VOR) && !context->isOverflow())
-  {
-    const QList<MapVor> *vors = mapQuery->getVors(curBox, context->mapLayer, context->lazyUpdate);
-    if(vors != nullptr)
-      paintVors(context, vors, context->drawFast);
-  }
+  if(!visibleVorList.isEmpty() && !context->isOverflow())
+    paintVors(context, visibleVorList, context->drawFast);
 
   // NDB -------------------------------------------------
-  if(context->mapLayer->isNdb() && context->objectTypes.testFlag(map::NDB) && !context->isOverflow())
-  {
-    const QList<MapNdb> *ndbs = mapQuery->getNdbs(curBox, context->mapLayer, context->lazyUpdate);
-    if(ndbs != nullptr)
-      paintNdbs(context, ndbs, context->drawFast);
-  }
+  if(!visibleNdbList.isEmpty() && !context->isOverflow())
+    paintNdbs(context, visibleNdbList, context->drawFast);
 
   // Marker -------------------------------------------------
-  if(context->mapLayer->isMarker() && context->objectTypes.testFlag(map::ILS) && !context->isOverflow())
+  if(!visibleMarkerList.isEmpty() && !context->isOverflow())
+    paintMarkers(context, visibleMarkerList, context->drawFast);
+
+  // Do not keep pointers into the caches
+  clearNavaids();
+}
+
+void MapPainterNav::countCandidates(PaintContext *context)
+{
+  // Collect navaids with screen positions once - render uses them for this paint event
+  collectNavaids(context);
+  navaidsCollected = true;
+
+  bool drawAirway = context->mapLayer->isAirway() &&
+                    (context->objectTypes.testFlag(map::AIRWAYJ) ||
+                     context->objectTypes.testFlag(map::AIRWAYV));
+  if(drawAirway)
   {
-    const QList<MapMarker> *markers = mapQuery->getMarkers(curBox, context->mapLayer, context->lazyUpdate);
-    if(markers != nullptr)
-      paintMarkers(context, markers, context->drawFast);
+    // Result is taken from the cache when painting
+    const QList<MapAirway> *airways = mapQuery->getAirways(context->viewport->viewLatLonAltBox(), context->mapLayer,
+                                                           context->viewContext == Marble::Animation);
+    if(airways != nullptr)
+    {
+      int num = 0;
+      for(const MapAirway& airway : *airways)
+      {
+        if(airway.bounding.overlaps(context->viewportRect))
+          num++;
+      }
+      context->objCandidates(MapPaintBudget::AIRWAY, num);
+    }
   }
+
+  context->objCandidates(MapPaintBudget::WAYPOINT, visibleWaypointList.size());
+  context->objCandidates(MapPaintBudget::VOR, visibleVorList.size());
+  context->objCandidates(MapPaintBudget::NDB, visibleNdbList.size());
+  context->objCandidates(MapPaintBudget::MARKER, visibleMarkerList.size());
 }
 
 /* Draw airways and texts */
@@ -168,7 +287,7 @@ void MapPainterNav::paintAirways(PaintContext *context, const QList<MapAirway> *
     // Draw line if both points are visible or line intersects screen coordinates
     if(visible1 || visible2)
     {
-      if(context->objCount())
+      if(context->objCount(MapPaintBudget::AIRWAY))
         return;
 
       drawLine(context, Line(airway.from, airway.to));
@@ -274,124 +393,126 @@ void MapPainterNav::paintAirways(PaintContext *context, const QList<MapAirway> *
 }
 
 /* Draw waypoints. If airways are enabled corresponding waypoints are drawn too */
-void MapPainterNav::paintWaypoints(PaintContext *context, const QList<MapWaypoint> *waypoints,
-                                   bool drawWaypoint, bool drawFast)
+void MapPainterNav::paintWaypoints(PaintContext *context, QVector<ScreenNavaid<MapWaypoint> >& visibleList,
+                                   bool drawFast)
 {
   bool drawAirwayV = context->mapLayer->isAirwayWaypoint() && context->objectTypes.testFlag(map::AIRWAYV);
   bool drawAirwayJ = context->mapLayer->isAirwayWaypoint() && context->objectTypes.testFlag(map::AIRWAYJ);
 
   bool fill = context->flags2 & opts::MAP_NAVAID_TEXT_BACKGROUND;
 
-  for(const MapWaypoint& waypoint : *waypoints)
-  {
-    // If waypoints are off, airways are on and waypoint has no airways skip it
-    if(!(drawWaypoint || (drawAirwayV && waypoint.hasVictorAirways) || (drawAirwayJ && waypoint.hasJetAirways)))
-      continue;
-
-    int x, y;
-    bool visible = wToS(waypoint.position, x, y);
-
-    if(visible)
-    {
-      if(context->objCount())
-        return;
-
-      int size = context->sz(context->symbolSizeNavaid, context->mapLayerEffective->getWaypointSymbolSize());
-      symbolPainter->drawWaypointSymbol(context->painter, QColor(), x, y, size, false, drawFast);
+  // Prefer waypoints on airways if not all can be drawn
+  thinNavaids(visibleList, context->objQuota(MapPaintBudget::WAYPOINT),
+              [](const MapWaypoint& wp1, const MapWaypoint& wp2) -> bool {
+    return (wp1.hasVictorAirways || wp1.hasJetAirways) > (wp2.hasVictorAirways || wp2.hasJetAirways);
+  });
 
-      // If airways are drawn force display of the respecive waypoints
-      if(context->mapLayer->isWaypointName() ||
-         (context->mapLayer->isAirwayIdent() && (drawAirwayV || drawAirwayJ)))
-        symbolPainter->drawWaypointText(context->painter, waypoint, x, y, textflags::IDENT, size, fill);
-    }
+  for(const ScreenNavaid<MapWaypoint>& screenWaypoint : visibleList)
+  {
+    if(context->objCount(MapPaintBudget::WAYPOINT))
+      return;
+
+    int size = context->sz(context->symbolSizeNavaid, context->mapLayerEffective->getWaypointSymbolSize());
+    symbolPainter->drawWaypointSymbol(context->painter, QColor(), screenWaypoint.x, screenWaypoint.y, size, false,
+                                      drawFast);
+
+    // If airways are drawn force display of the respecive waypoints
+    if(context->mapLayer->isWaypointName() ||
+       (context->mapLayer->isAirwayIdent() && (drawAirwayV || drawAirwayJ)))
+      symbolPainter->drawWaypointText(context->painter, *screenWaypoint.navaid, screenWaypoint.x, screenWaypoint.y,
+                                      textflags::IDENT, size, fill);
   }
 }
 
-void MapPainterNav::paintVors(PaintContext *context, const QList<MapVor> *vors, bool drawFast)
+void MapPainterNav::paintVors(PaintContext *context, QVector<ScreenNavaid<MapVor> >& visibleList, bool drawFast)
 {
   bool fill = context->flags2 & opts::MAP_NAVAID_TEXT_BACKGROUND;
 
-  for(const MapVor& vor : *vors)
+  // Prefer VOR with larger range if not all can be drawn
+  thinNavaids(visibleList, context->objQuota(MapPaintBudget::VOR),
+              [](const MapVor& vor1, const MapVor& vor2) -> bool {
+    return vor1.range > vor2.range;
+  });
+
+  for(const ScreenNavaid<MapVor>& screenVor : visibleList)
   {
-    int x, y;
-    bool visible = wToS(vor.position, x, y);
+    const MapVor& vor = *screenVor.navaid;
+    int x = screenVor.x, y = screenVor.y;
 
-    if(visible)
-    {
-      if(context->objCount())
-        return;
+    if(context->objCount(MapPaintBudget::VOR))
+      return;
 
-      int size = context->sz(context->symbolSizeNavaid, context->mapLayerEffective->getVorSymbolSize());
-      symbolPainter->drawVorSymbol(context->painter, vor, x, y,
-                                   size, false, drawFast,
-                                   context->mapLayerEffective->isVorLarge() ? size * 5 : 0);
+    int size = context->sz(context->symbolSizeNavaid, context->mapLayerEffective->getVorSymbolSize());
+    symbolPainter->drawVorSymbol(context->painter, vor, x, y,
+                                 size, false, drawFast,
+                                 context->mapLayerEffective->isVorLarge() ? size * 5 : 0);
 
-      textflags::TextFlags flags;
+    textflags::TextFlags flags;
 
-      if(context->mapLayer->isVorInfo())
-        flags = textflags::IDENT | textflags::TYPE | textflags::FREQ;
-      else if(context->mapLayer->isVorIdent())
-        flags = textflags::IDENT;
+    if(context->mapLayer->isVorInfo())
+      flags = textflags::IDENT | textflags::TYPE | textflags::FREQ;
+    else if(context->mapLayer->isVorIdent())
+      flags = textflags::IDENT;
 
-      symbolPainter->drawVorText(context->painter, vor, x, y, flags, size, fill);
-    }
+    symbolPainter->drawVorText(context->painter, vor, x, y, flags, size, fill);
   }
 }
 
-void MapPainterNav::paintNdbs(PaintContext *context, const QList<MapNdb> *ndbs, bool drawFast)
+void MapPainterNav::paintNdbs(PaintContext *context, QVector<ScreenNavaid<MapNdb> >& visibleList, bool drawFast)
 {
   bool fill = context->flags2 & opts::MAP_NAVAID_TEXT_BACKGROUND;
 
-  for(const MapNdb& ndb : *ndbs)
+  // Prefer NDB with larger range if not all can be drawn
+  thinNavaids(visibleList, context->objQuota(MapPaintBudget::NDB),
+              [](const MapNdb& ndb1, const MapNdb& ndb2) -> bool {
+    return ndb1.range > ndb2.range;
+  });
+
+  for(const ScreenNavaid<MapNdb>& screenNdb : visibleList)
   {
-    int x, y;
-    bool visible = wToS(ndb.position, x, y);
+    const MapNdb& ndb = *screenNdb.navaid;
+    int x = screenNdb.x, y = screenNdb.y;
 
-    if(visible)
-    {
-      if(context->objCount())
-        return;
+    if(context->objCount(MapPaintBudget::NDB))
+      return;
 
-      int size = context->sz(context->symbolSizeNavaid, context->mapLayerEffective->getNdbSymbolSize());
-      symbolPainter->drawNdbSymbol(context->painter, x, y, size, false, drawFast);
+    int size = context->sz(context->symbolSizeNavaid, context->mapLayerEffective->getNdbSymbolSize());
+    symbolPainter->drawNdbSymbol(context->painter, x, y, size, false, drawFast);
 
-      textflags::TextFlags flags;
+    textflags::TextFlags flags;
 
-      if(context->mapLayer->isNdbInfo())
-        flags = textflags::IDENT | textflags::TYPE | textflags::FREQ;
-      else if(context->mapLayer->isNdbIdent())
-        flags = textflags::IDENT;
+    if(context->mapLayer->isNdbInfo())
+      flags = textflags::IDENT | textflags::TYPE | textflags::FREQ;
+    else if(context->mapLayer->isNdbIdent())
+      flags = textflags::IDENT;
 
-      symbolPainter->drawNdbText(context->painter, ndb, x, y, flags, size, fill);
-    }
+    symbolPainter->drawNdbText(context->painter, ndb, x, y, flags, size, fill);
   }
 }
 
-void MapPainterNav::paintMarkers(PaintContext *context, const QList<MapMarker> *markers, bool drawFast)
+void MapPainterNav::paintMarkers(PaintContext *context, const QVector<ScreenNavaid<MapMarker> >& visibleList,
+                                 bool drawFast)
 {
   int transparency = context->flags2 & opts::MAP_NAVAID_TEXT_BACKGROUND ? 255 : 0;
 
-  for(const MapMarker& marker : *markers)
+  for(const ScreenNavaid<MapMarker>& screenMarker : visibleList)
   {
-    int x, y;
-    bool visible = wToS(marker.position, x, y);
+    const MapMarker& marker = *screenMarker.navaid;
+    int x = screenMarker.x, y = screenMarker.y;
 
-    if(visible)
-    {
-      if(context->objCount())
-        return;
+    if(context->objCount(MapPaintBudget::MARKER))
+      return;
 
-      int size = context->sz(context->symbolSizeNavaid, context->mapLayerEffective->getMarkerSymbolSize());
-      symbolPainter->drawMarkerSymbol(context->painter, marker, x, y, size, drawFast);
+    int size = context->sz(context->symbolSizeNavaid, context->mapLayerEffective->getMarkerSymbolSize());
+    symbolPainter->drawMarkerSymbol(context->painter, marker, x, y, size, drawFast);
 
-      if(context->mapLayer->isMarkerInfo())
-      {
-        QString type = marker.type.toLower();
-        type[0] = type.at(0).toUpper();
-        x -= size / 2 + 2;
-        symbolPainter->textBox(context->painter, {type}, mapcolors::markerSymbolColor, x, y,
-                               textatt::BOLD | textatt::RIGHT, transparency);
-      }
+    if(context->mapLayer->isMarkerInfo())
+    {
+      QString type = marker.type.toLower();
+      type[0] = type.at(0).toUpper();
+      x -= size / 2 + 2;
+      symbolPainter->textBox(context->painter, {type}, mapcolors::markerSymbolColor, x, y,
+                             textatt::BOLD | textatt::RIGHT, transparency);
     }
   }
 }
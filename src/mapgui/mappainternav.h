@@ -37,15 +37,48 @@ public:
   virtual ~MapPainterNav();
 
   virtual void render(PaintContext *context) override;
+  virtual void countCandidates(PaintContext *context) override;
 
 private:
-  void paintMarkers(PaintContext *context, const QList<map::MapMarker> *markers, bool drawFast);
-  void paintNdbs(PaintContext *context, const QList<map::MapNdb> *ndbs, bool drawFast);
-  void paintVors(PaintContext *context, const QList<map::MapVor> *vors, bool drawFast);
-  void paintWaypoints(PaintContext *context, const QList<map::MapWaypoint> *waypoints,
-                      bool drawWaypoint, bool drawFast);
+  /* Navaid and its screen position */
+  template<typename TYPE>
+  struct ScreenNavaid
+  {
+    const TYPE *navaid;
+    int x, y;
+  };
+
+  /* Get all navaids passing the filter with a visible position */
+  template<typename TYPE, typename FILTER>
+  QVector<ScreenNavaid<TYPE> > visibleNavaids(const QList<TYPE> *navaids, FILTER filter);
+
+  /* Keep only the most important navaids if there are more than the quota allows */
+  template<typename TYPE, typename MOREIMPORTANT>
+  void thinNavaids(QVector<ScreenNavaid<TYPE> >& navaids, int quota, MOREIMPORTANT moreImportant);
+
+  /* Get visible waypoints which are either enabled or needed for the shown airways */
+  QVector<ScreenNavaid<map::MapWaypoint> > visibleWaypoints(const PaintContext *context,
+                                                            const QList<map::MapWaypoint> *waypoints,
+                                                            bool drawWaypoint);
+
+  /* Fill the lists of visible navaids for all enabled types */
+  void collectNavaids(const PaintContext *context);
+  void clearNavaids();
+
+  void paintMarkers(PaintContext *context, const QVector<ScreenNavaid<map::MapMarker> >& visibleList, bool drawFast);
+  void paintNdbs(PaintContext *context, QVector<ScreenNavaid<map::MapNdb> >& visibleList, bool drawFast);
+  void paintVors(PaintContext *context, QVector<ScreenNavaid<map::MapVor> >& visibleList, bool drawFast);
+  void paintWaypoints(PaintContext *context, QVector<ScreenNavaid<map::MapWaypoint> >& visibleList, bool drawFast);
   void paintAirways(PaintContext *context, const QList<map::MapAirway> *airways, bool fast);
 
+  /* Visible navaids with screen positions. Filled by countCandidates() and used by the following render() call
+   * to avoid a second projection. Point into the query caches and are cleared after painting. */
+  QVector<ScreenNavaid<map::MapWaypoint> > visibleWaypointList;
+  QVector<ScreenNavaid<map::MapVor> > visibleVorList;
+  QVector<ScreenNavaid<map::MapNdb> > visibleNdbList;
+  QVector<ScreenNavaid<map::MapMarker> > visibleMarkerList;
+  bool navaidsCollected = false;
+
 };
 
 #endif // LITTLENAVMAP_MAPPAINTERAIRPORT_H
@@ -50,56 +50,87 @@ MapPainterUser::~MapPainterUser()
 
 void MapPainterUser::render(PaintContext *context)
 {
-  const GeoDataLatLonAltBox& curBox = context->viewport->viewLatLonAltBox();
-
   atools::util::PainterContextSaver saver(context->painter);
   Q_UNUSED(saver);
 
   context->szFont(context->textSizeNavaid);
 
-  // Always call paint to fill cache
-  paintUserpoints(context,
-                  mapQuery->getUserdataPoints(curBox, context->userPointTypes, context->userPointTypesAll,
-                                              context->userPointTypeUnknown,
-                                              context->distance), context->drawFast);
+  // Always query if not counted for this paint event to fill cache
+  if(!userpointsCollected)
+    collectUserpoints(context);
+
+  paintUserpoints(context, visibleUserpoints, context->drawFast);
+
+  visibleUserpoints.clear();
+  userpointsCollected = false;
 }
 
-void MapPainterUser::paintUserpoints(PaintContext *context, const QList<MapUserpoint>& userpoints, bool drawFast)
+void MapPainterUser::countCandidates(PaintContext *context)
 {
-  bool fill = context->flags2 & opts::MAP_NAVAID_TEXT_BACKGROUND;
-  UserdataIcons *icons = NavApp::getUserdataIcons();
+  visibleUserpoints.clear();
+  userpointsCollected = false;
+
+  // Nothing to query if no userpoint type is selected - render will clear the cache
+  if(context->userPointTypes.isEmpty() && !context->userPointTypeUnknown)
+    return;
+
+  // Query and project once - render uses the result for this paint event
+  collectUserpoints(context);
+  userpointsCollected = true;
+
+  context->objCandidates(MapPaintBudget::USERPOINT, visibleUserpoints.size());
+}
+
+void MapPainterUser::collectUserpoints(const PaintContext *context)
+{
+  visibleUserpoints.clear();
 
+  const QList<MapUserpoint> userpoints =
+    mapQuery->getUserdataPoints(context->viewport->viewLatLonAltBox(), context->userPointTypes,
+                                context->userPointTypesAll, context->userPointTypeUnknown, context->distance);
   for(const MapUserpoint& userpoint : userpoints)
   {
     float x, y;
-    bool visible = wToS(userpoint.position, x, y);
+    if(wToS(userpoint.position, x, y))
+      visibleUserpoints.append(std::make_pair(userpoint, QPointF(x, y)));
+  }
+}
+
+void MapPainterUser::paintUserpoints(PaintContext *context, const QList<PaintUserpointType>& userpoints,
+                                     bool drawFast)
+{
+  bool fill = context->flags2 & opts::MAP_NAVAID_TEXT_BACKGROUND;
+  UserdataIcons *icons = NavApp::getUserdataIcons();
+
+  for(const PaintUserpointType& paintUserpoint : userpoints)
+  {
+    const MapUserpoint& userpoint = paintUserpoint.first;
+    float x = static_cast<float>(paintUserpoint.second.x());
+    float y = static_cast<float>(paintUserpoint.second.y());
+
+    if(context->objCount(MapPaintBudget::USERPOINT))
+      return;
 
-    if(visible)
+    if(icons->hasType(userpoint.type) || context->userPointTypeUnknown)
     {
-      if(context->objCount())
-        return;
+      int size = context->sz(context->symbolSizeNavaid, context->mapLayerEffective->getUserPointSymbolSize());
+      context->painter->drawPixmap(QPointF(x - size / 2, y - size / 2),
+                                   *icons->getIconPixmap(userpoint.type, size));
 
-      if(icons->hasType(userpoint.type) || context->userPointTypeUnknown)
+      if(context->mapLayer->isUserpointInfo() && !drawFast)
       {
-        int size = context->sz(context->symbolSizeNavaid, context->mapLayerEffective->getUserPointSymbolSize());
-        context->painter->drawPixmap(QPointF(x - size / 2, y - size / 2),
-                                     *icons->getIconPixmap(userpoint.type, size));
-
-        if(context->mapLayer->isUserpointInfo() && !drawFast)
-        {
-          int maxTextLength = context->mapLayer->getMaxTextLengthUserpoint();
-
-          // Avoid showing same text twice
-          QStringList texts;
-          texts.append(atools::elideTextShort(userpoint.ident, maxTextLength));
-          QString name = userpoint.name != userpoint.ident ?
-                         atools::elideTextShort(userpoint.name, maxTextLength) : QString();
-          if(!name.isEmpty())
-            texts.append(name);
-
-          symbolPainter->textBoxF(context->painter, texts, QPen(Qt::black),
-                                  x + size / 2, y, textatt::LEFT, fill ? 255 : 0);
-        }
+        int maxTextLength = context->mapLayer->getMaxTextLengthUserpoint();
+
+        // Avoid showing same text twice
+        QStringList texts;
+        texts.append(atools::elideTextShort(userpoint.ident, maxTextLength));
+        QString name = userpoint.name != userpoint.ident ?
+                       atools::elideTextShort(userpoint.name, maxTextLength) : QString();
+        if(!name.isEmpty())
+          texts.append(name);
+
+        symbolPainter->textBoxF(context->painter, texts, QPen(Qt::black),
+                                x + size / 2, y, textatt::LEFT, fill ? 255 : 0);
       }
     }
   }
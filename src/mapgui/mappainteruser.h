@@ -35,9 +35,19 @@ public:
   virtual ~MapPainterUser();
 
   virtual void render(PaintContext *context) override;
+  virtual void countCandidates(PaintContext *context) override;
 
 private:
-  void paintUserpoints(PaintContext *context, const QList<map::MapUserpoint>& userpoints, bool drawFast);
+  typedef std::pair<map::MapUserpoint, QPointF> PaintUserpointType;
+
+  /* Query userpoints and keep the visible ones with their screen position */
+  void collectUserpoints(const PaintContext *context);
+
+  void paintUserpoints(PaintContext *context, const QList<PaintUserpointType>& userpoints, bool drawFast);
+
+  /* Filled by countCandidates() and used by the following render() call to avoid a second query */
+  QList<PaintUserpointType> visibleUserpoints;
+  bool userpointsCollected = false;
 
 };
 
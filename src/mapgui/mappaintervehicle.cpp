@@ -166,11 +166,26 @@ void MapPainterVehicle::paintTrack(const PaintContext *context)
     int x2 = -1, y2 = -1;
     bool hidden1, hidden2;
     QRect vpRect(painter->viewport());
-    wToS(aircraftTrack.first().pos, x1, y1, DEFAULT_WTOS_SIZE, &hidden1);
 
-    for(int i = 1; i < aircraftTrack.size(); i++)
+    // Use a simplified track where positions are about the minimum line length apart on the screen
+    int level = 0;
+    float pixelPerKm = scale->isValid() ? scale->getPixelForMeter(1000.f) : 0.f;
+    if(pixelPerKm > 0.f)
+      level = aircraftTrack.getLevelForDistance(AIRCRAFT_TRACK_MIN_LINE_LENGTH / pixelPerKm * 1000.f);
+
+    if(aircraftTrack.getLevelSize(level) == 0)
+      // Fall back to full resolution if a level is empty
+      level = 0;
+
+    // Simplified levels might not contain the latest position - add it to connect the track to the aircraft
+    int levelSize = aircraftTrack.getLevelSize(level);
+    int numPoints = level > 0 ? levelSize + 1 : levelSize;
+
+    wToS(aircraftTrack.getLevelPos(level, 0).pos, x1, y1, DEFAULT_WTOS_SIZE, &hidden1);
+
+    for(int i = 1; i < numPoints; i++)
     {
-      const at::AircraftTrackPos& trackPos = aircraftTrack.at(i);
+      const at::AircraftTrackPos& trackPos = i < levelSize ? aircraftTrack.getLevelPos(level, i) : aircraftTrack.last();
       wToS(trackPos.pos, x2, y2, DEFAULT_WTOS_SIZE, &hidden2);
 
       QRect rect(QPoint(x1, y1), QPoint(x2, y2));
@@ -223,9 +238,12 @@ void MapPainterVehicle::paintTextLabelAi(const PaintContext *context, float x, f
 {
   QStringList texts;
 
-  if((aircraft.isOnGround() && context->mapLayer->isAiAircraftGroundText()) || // All AI on ground
-     (!aircraft.isOnGround() && context->mapLayer->isAiAircraftText()) || // All AI in the air
-     (aircraft.isOnline() && context->mapLayer->isOnlineAircraftText()) || // All online
+  // Labels for all aircraft are omitted if map painting is too slow
+  bool allLabels = !context->aiLabelsClosestOnly;
+
+  if((allLabels && aircraft.isOnGround() && context->mapLayer->isAiAircraftGroundText()) || // All AI on ground
+     (allLabels && !aircraft.isOnGround() && context->mapLayer->isAiAircraftText()) || // All AI in the air
+     (allLabels && aircraft.isOnline() && context->mapLayer->isOnlineAircraftText()) || // All online
      forceLabel) // Force label for nearby aircraft
   {
     appendAtcText(texts, aircraft, context->dOpt(opts::ITEM_AI_AIRCRAFT_REGISTRATION),
@@ -33,14 +33,20 @@
 #include "mapgui/mappainteruser.h"
 #include "mapgui/mappainteraltitude.h"
 #include "mapgui/mapscale.h"
+#include "mapgui/mapdetailgovernor.h"
 #include "userdata/userdatacontroller.h"
 #include "route/route.h"
 #include "geo/calculations.h"
 #include "options/optiondata.h"
+#include "atools.h"
+#include "common/paintstatistics.h"
+#include "util/paintercontextsaver.h"
 
 #include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentRun>
 
 #include <marble/GeoPainter.h>
+#include <marble/ViewportParams.h>
 
 using namespace Marble;
 using namespace atools::geo;
@@ -52,6 +58,7 @@ MapPaintLayer::MapPaintLayer(MapWidget *widget, MapQuery *mapQueries)
   initMapLayerSettings();
 
   mapScale = new MapScale();
+  detailGovernor = new MapDetailGovernor();
 
   // Create all painters
   mapPainterNav = new MapPainterNav(mapWidget, mapScale);
@@ -68,6 +75,8 @@ MapPaintLayer::MapPaintLayer(MapWidget *widget, MapQuery *mapQueries)
   // Default for visible object types
   objectTypes = map::MapObjectTypes(map::AIRPORT | map::VOR | map::NDB | map::AP_ILS | map::MARKER | map::WAYPOINT);
   objectDisplayTypes = map::DISPLAY_TYPE_NONE;
+
+  optionsChanged();
 }
 
 MapPaintLayer::~MapPaintLayer()
@@ -85,16 +94,27 @@ MapPaintLayer::~MapPaintLayer()
 
   delete layers;
   delete mapScale;
+  delete detailGovernor;
+
+  // Write remaining statistics and close the log file
+  pstats::setEnabled(false);
+}
+
+void MapPaintLayer::optionsChanged()
+{
+  pstats::setEnabled(OptionData::instance().getFlags2() & opts::MAP_PAINT_STATISTICS);
 }
 
 void MapPaintLayer::preDatabaseLoad()
 {
   databaseLoadStatus = true;
+  invalidateStaticLayer();
 }
 
 void MapPaintLayer::postDatabaseLoad()
 {
   databaseLoadStatus = false;
+  invalidateStaticLayer();
 }
 
 void MapPaintLayer::setShowMapObjects(map::MapObjectTypes type, bool show)
@@ -103,6 +123,7 @@ void MapPaintLayer::setShowMapObjects(map::MapObjectTypes type, bool show)
     objectTypes |= type;
   else
     objectTypes &= ~type;
+  invalidateStaticLayer();
 }
 
 void MapPaintLayer::setShowMapObjectsDisplay(map::MapObjectDisplayTypes type, bool show)
@@ -111,17 +132,20 @@ void MapPaintLayer::setShowMapObjectsDisplay(map::MapObjectDisplayTypes type, bo
     objectDisplayTypes |= type;
   else
     objectDisplayTypes &= ~type;
+  invalidateStaticLayer();
 }
 
 void MapPaintLayer::setShowAirspaces(map::MapAirspaceFilter types)
 {
   airspaceTypes = types;
+  invalidateStaticLayer();
 }
 
 void MapPaintLayer::setDetailFactor(int factor)
 {
   detailFactor = factor;
   updateLayers();
+  invalidateStaticLayer();
 }
 
 map::MapAirspaceFilter MapPaintLayer::getShownAirspacesTypesByLayer() const
@@ -387,7 +411,8 @@ void MapPaintLayer::updateLayers()
   float dist = static_cast<float>(mapWidget->distance());
   // Get the uncorrected effective layer - route painting is independent of declutter
   mapLayerEffective = layers->getLayer(dist);
-  mapLayer = layers->getLayer(dist, detailFactor);
+  // Detail reduced by governor if painting is too slow
+  mapLayer = layers->getLayer(dist, detailFactor - detailGovernor->getDetailFactorReduction());
 }
 
 bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport,
@@ -398,6 +423,18 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport,
 
   if(!databaseLoadStatus)
   {
+    pstats::beginFrame();
+
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+
+    // Adapt details to frame time if enabled - always print with full details
+    bool adaptiveDetail = OptionData::instance().getFlags2() & opts::MAP_ADAPTIVE_DETAIL && !mapWidget->isPrinting();
+    if(adaptiveDetail)
+      detailGovernor->setTargetFrameTime(OptionData::instance().getMapAdaptiveDetailFrameTime());
+    else if(detailGovernor->reset())
+      invalidateStaticLayer();
+
     // Update map scale for screen distance approximation
     mapScale->update(viewport, mapWidget->distance());
 
@@ -421,6 +458,9 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport,
       context.drawFast = (mapScrollDetail == opts::FULL || mapScrollDetail == opts::HIGHER) ?
                          false : mapWidget->viewContext() == Marble::Animation;
       context.lazyUpdate = mapScrollDetail == opts::FULL ? false : mapWidget->viewContext() == Marble::Animation;
+      context.drawFast |= detailGovernor->isDrawFast();
+      context.airspaceFill = detailGovernor->isAirspaceFill();
+      context.aiLabelsClosestOnly = detailGovernor->isAiLabelsClosestOnly();
       context.mapScrollDetail = mapScrollDetail;
       context.distance = atools::geo::meterToNm(static_cast<float>(mapWidget->distance() * 1000.));
 
@@ -464,6 +504,7 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport,
       context.flags2 = od.getFlags2();
 
       context.weatherSource = weatherSource;
+      context.budget = &objectBudget;
 
       if(mapWidget->viewContext() == Marble::Still)
       {
@@ -478,62 +519,359 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport,
         painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
       }
 
-      // Altitude below all others
-      mapPainterAltitude->render(&context);
+      // Use the cached image of static objects only if connected since the map is repainted on
+      // each simulator update
+      bool useStaticLayer = NavApp::isConnected() && !mapWidget->isPrinting() &&
+                            mapWidget->viewContext() == Marble::Still;
 
-      // Ship below other navaids and airports
-      mapPainterShip->render(&context);
+      // Frames using a cached image are not used to adapt the details
+      bool fullFrame = true;
 
-      if(mapWidget->distance() < layer::DISTANCE_CUT_OFF_LIMIT)
+      if(useStaticLayer)
       {
-        if(!context.isOverflow())
-          mapPainterAirspace->render(&context);
-
-        if(context.mapLayerEffective->isAirportDiagram())
-        {
-          // Put ILS below and navaids on top of airport diagram
-          mapPainterIls->render(&context);
-
-          if(!context.isOverflow())
-            mapPainterAirport->render(&context);
-
-          if(!context.isOverflow())
-            mapPainterNav->render(&context);
-        }
+        // Altitude, ship, airspaces, navaids, airports and userpoints with all except ships from images
+        fullFrame = renderStaticLayerCached(&context);
+      }
+      else
+      {
+        // Drop the image to free memory
+        staticLayerImage = QImage();
+        staticLayerAltitudeImage = QImage();
+        invalidateStaticLayer();
+
+        if(useParallelRendering())
+          // Altitude, ship, airspaces, navaids, airports and userpoints using worker threads
+          renderStaticPaintersParallel(&context, true /* paint altitude */, true /* paint ship */);
         else
         {
-          // Airports on top of all
-          if(!context.isOverflow())
-            mapPainterIls->render(&context);
+          // Altitude below all others
+          renderPainter(mapPainterAltitude, &context, "Altitude");
 
-          if(!context.isOverflow())
-            mapPainterNav->render(&context);
+          // Ship below other navaids and airports
+          renderPainter(mapPainterShip, &context, "Ship");
 
-          if(!context.isOverflow())
-            mapPainterAirport->render(&context);
+          renderStaticPainters(&context);
         }
       }
 
-      if(!context.isOverflow())
-        mapPainterUser->render(&context);
-
       // if(!context.isOverflow()) always paint route even if number of objets is too large
-      mapPainterRoute->render(&context);
+      renderPainter(mapPainterRoute, &context, "Route");
 
       // if(!context.isOverflow())
-      mapPainterMark->render(&context);
+      renderPainter(mapPainterMark, &context, "Mark");
 
-      mapPainterAircraft->render(&context);
+      renderPainter(mapPainterAircraft, &context, "Aircraft");
 
+      // Objects left out by the budget plan or by exceeding the total number
+      overflow = objectBudget.getNumThinned();
       if(context.isOverflow())
-        overflow = PaintContext::MAX_OBJECT_COUNT;
-      else
-        overflow = 0;
+        overflow = std::max(overflow, 1);
+
+      pstats::endFrame(context.objectCount);
+
+      if(adaptiveDetail && fullFrame && detailGovernor->addFrameTime(frameTimer.elapsed()))
+        // Level changed - details are applied with the next frame
+        invalidateStaticLayer();
     }
 
     if(!mapWidget->isPrinting())
+    {
       // Dim the map by drawing a semi-transparent black rectangle
       mapcolors::darkenPainterRect(*painter);
+
+      if(pstats::isEnabled())
+        paintStatisticsOverlay(painter);
+    }
   }
   return true;
 }
+
+void MapPaintLayer::planObjectBudget(PaintContext *context)
+{
+  objectBudget.clear();
+
+  // Same conditions as in renderStaticPainters() and renderNavaidPainters()
+  if(mapWidget->distance() < layer::DISTANCE_CUT_OFF_LIMIT)
+  {
+    mapPainterAirspace->countCandidates(context);
+    mapPainterIls->countCandidates(context);
+    mapPainterNav->countCandidates(context);
+    mapPainterAirport->countCandidates(context);
+  }
+  mapPainterUser->countCandidates(context);
+
+  // Leave some objects for highlights and other painters not using the plan
+  objectBudget.plan(PaintContext::MAX_OBJECT_COUNT - PaintContext::RESERVED_OBJECT_COUNT - context->objectCount);
+}
+
+void MapPaintLayer::renderStaticPainters(PaintContext *context)
+{
+  planObjectBudget(context);
+
+  if(mapWidget->distance() < layer::DISTANCE_CUT_OFF_LIMIT && !context->isOverflow())
+    renderPainter(mapPainterAirspace, context, "Airspace");
+
+  renderNavaidPainters(context);
+}
+
+void MapPaintLayer::renderNavaidPainters(PaintContext *context)
+{
+  if(mapWidget->distance() < layer::DISTANCE_CUT_OFF_LIMIT)
+  {
+    if(context->mapLayerEffective->isAirportDiagram())
+    {
+      // Put ILS below and navaids on top of airport diagram
+      renderPainter(mapPainterIls, context, "ILS");
+
+      if(!context->isOverflow())
+        renderPainter(mapPainterAirport, context, "Airport");
+
+      if(!context->isOverflow())
+        renderPainter(mapPainterNav, context, "Navaid");
+    }
+    else
+    {
+      // Airports on top of all
+      if(!context->isOverflow())
+        renderPainter(mapPainterIls, context, "ILS");
+
+      if(!context->isOverflow())
+        renderPainter(mapPainterNav, context, "Navaid");
+
+      if(!context->isOverflow())
+        renderPainter(mapPainterAirport, context, "Airport");
+    }
+  }
+
+  if(!context->isOverflow())
+    renderPainter(mapPainterUser, context, "Userpoint");
+}
+
+bool MapPaintLayer::renderStaticLayerCached(PaintContext *context)
+{
+  ViewportParams *viewport = context->viewport;
+  GeoPainter *painter = context->painter;
+  bool painted = false;
+
+  if(!staticLayerValid || !isStaticLayerCurrent(viewport))
+  {
+    pstats::ScopedTimer timer("Static layer", context->objectCount);
+
+    // Viewport, options or data have changed - paint all into a new transparent image
+    qreal pixelRatio = mapWidget->devicePixelRatioF();
+    staticLayerImage = QImage(viewport->size() * pixelRatio, QImage::Format_ARGB32_Premultiplied);
+    staticLayerImage.setDevicePixelRatio(pixelRatio);
+    staticLayerImage.fill(Qt::transparent);
+    staticLayerAltitudeImage = QImage(viewport->size() * pixelRatio, QImage::Format_ARGB32_Premultiplied);
+    staticLayerAltitudeImage.setDevicePixelRatio(pixelRatio);
+    staticLayerAltitudeImage.fill(Qt::transparent);
+
+    {
+      // Altitude grid goes into an own image to keep the ships between it and the other static objects
+      GeoPainter imagePainter(&staticLayerAltitudeImage, viewport, painter->mapQuality());
+      imagePainter.setFont(painter->font());
+      imagePainter.setRenderHints(painter->renderHints());
+
+      context->painter = &imagePainter;
+      renderPainter(mapPainterAltitude, context, "Altitude");
+      context->painter = painter;
+    }
+
+    {
+      GeoPainter imagePainter(&staticLayerImage, viewport, painter->mapQuality());
+      imagePainter.setFont(painter->font());
+      imagePainter.setRenderHints(painter->renderHints());
+
+      // Let all other static painters draw into the image
+      context->painter = &imagePainter;
+      if(useParallelRendering())
+        renderStaticPaintersParallel(context, false /* paint altitude */, false /* paint ship */);
+      else
+        renderStaticPainters(context);
+      context->painter = painter;
+    }
+
+    // Remember the state for the next check
+    staticLayerObjectCount = context->objectCount;
+    staticLayerSize = viewport->size();
+    staticLayerDevicePixelRatio = pixelRatio;
+    staticLayerRadius = viewport->radius();
+    staticLayerCenterLon = viewport->centerLongitude();
+    staticLayerCenterLat = viewport->centerLatitude();
+    staticLayerProjection = viewport->projection();
+    staticLayerValid = true;
+    painted = true;
+  }
+  else
+    // Nothing changed - restore number of objects for overflow check
+    context->objectCount = staticLayerObjectCount;
+
+  // Same order as without cache. Ships are updated with each simulator update and are never cached.
+  painter->drawImage(QPointF(0., 0.), staticLayerAltitudeImage);
+  renderPainter(mapPainterShip, context, "Ship");
+  painter->drawImage(QPointF(0., 0.), staticLayerImage);
+  return painted;
+}
+
+bool MapPaintLayer::isStaticLayerCurrent(const ViewportParams *viewport) const
+{
+  return !staticLayerImage.isNull() &&
+         staticLayerSize == viewport->size() &&
+         atools::almostEqual(staticLayerDevicePixelRatio, mapWidget->devicePixelRatioF(), 0.001) &&
+         staticLayerRadius == viewport->radius() &&
+         atools::almostEqual(staticLayerCenterLon, viewport->centerLongitude(), 1.e-9) &&
+         atools::almostEqual(staticLayerCenterLat, viewport->centerLatitude(), 1.e-9) &&
+         staticLayerProjection == viewport->projection();
+}
+
+bool MapPaintLayer::useParallelRendering() const
+{
+  return OptionData::instance().getFlags2() & opts::MAP_PARALLEL_RENDERING && !mapWidget->isPrinting();
+}
+
+void MapPaintLayer::renderStaticPaintersParallel(PaintContext *context, bool paintAltitude, bool paintShip)
+{
+  GeoPainter *painter = context->painter;
+  ViewportParams *viewport = context->viewport;
+  Marble::MapQuality quality = painter->mapQuality();
+  QPainter::RenderHints hints = painter->renderHints();
+  QFont font = painter->font();
+
+  planObjectBudget(context);
+
+  // Load airspaces and geometry in this thread since database and caches cannot be accessed by the workers
+  bool paintAirspaces = mapWidget->distance() < layer::DISTANCE_CUT_OFF_LIMIT && !context->isOverflow();
+  if(paintAirspaces)
+  {
+    pstats::ScopedTimer timer("Airspace prepare", context->objectCount);
+    mapPainterAirspace->prepare(context);
+  }
+
+  if(paintAltitude)
+    initLayerImage(layerImageAltitude, viewport);
+  initLayerImage(layerImageAirspace, viewport);
+  initLayerImage(layerImageNavaid, viewport);
+
+  // Each worker gets an own copy of the context and an own image
+  int objectCountBefore = context->objectCount;
+  PaintContext altitudeContext(*context), airspaceContext(*context);
+
+  // The airspace worker counts on its own - reserve its share of the total number of objects
+  // for the navaid painters running meanwhile. prepare() limits the number to the quota of the plan.
+  int airspaceShare = paintAirspaces ? mapPainterAirspace->getNumPrepared() : 0;
+  context->objectCount += airspaceShare;
+
+  // Minimum altitude grid does not need any database access
+  QFuture<void> altitudeFuture;
+  if(paintAltitude)
+  {
+    altitudeFuture = QtConcurrent::run([&]() -> void
+    {
+      GeoPainter imagePainter(&layerImageAltitude, viewport, quality);
+      imagePainter.setRenderHints(hints);
+      imagePainter.setFont(font);
+      altitudeContext.painter = &imagePainter;
+      renderPainter(mapPainterAltitude, &altitudeContext, "Altitude");
+    });
+  }
+
+  QFuture<void> airspaceFuture;
+  if(paintAirspaces)
+  {
+    // Airspaces paint from the data collected in prepare()
+    airspaceFuture = QtConcurrent::run([&]() -> void
+    {
+      GeoPainter imagePainter(&layerImageAirspace, viewport, quality);
+      imagePainter.setRenderHints(hints);
+      imagePainter.setFont(font);
+      airspaceContext.painter = &imagePainter;
+      pstats::ScopedTimer timer("Airspace", airspaceContext.objectCount);
+      mapPainterAirspace->paint(&airspaceContext);
+    });
+  }
+
+  {
+    // Navaids, airports and userpoints need database access - paint in this thread meanwhile
+    GeoPainter imagePainter(&layerImageNavaid, viewport, quality);
+    imagePainter.setRenderHints(hints);
+    imagePainter.setFont(font);
+    context->painter = &imagePainter;
+    renderNavaidPainters(context);
+    context->painter = painter;
+  }
+
+  altitudeFuture.waitForFinished();
+  airspaceFuture.waitForFinished();
+
+  // Merge layers in the same order as the sequential painting
+  if(paintAltitude)
+    painter->drawImage(QPointF(0., 0.), layerImageAltitude);
+
+  if(paintShip)
+    renderPainter(mapPainterShip, context, "Ship");
+
+  // Replace the reserved share with the number of airspaces actually drawn
+  context->objectCount -= airspaceShare;
+  if(paintAirspaces)
+  {
+    painter->drawImage(QPointF(0., 0.), layerImageAirspace);
+    context->objectCount += airspaceContext.objectCount - objectCountBefore;
+  }
+
+  painter->drawImage(QPointF(0., 0.), layerImageNavaid);
+}
+
+void MapPaintLayer::initLayerImage(QImage& image, const ViewportParams *viewport) const
+{
+  qreal pixelRatio = mapWidget->devicePixelRatioF();
+  QSize size = viewport->size() * pixelRatio;
+
+  if(image.size() != size)
+  {
+    image = QImage(size, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(pixelRatio);
+  }
+  image.fill(Qt::transparent);
+}
+
+void MapPaintLayer::renderPainter(MapPainter *mapPainter, PaintContext *context, const char *name)
+{
+  pstats::ScopedTimer timer(name, context->objectCount);
+  mapPainter->render(context);
+}
+
+void MapPaintLayer::paintStatisticsOverlay(GeoPainter *painter)
+{
+  QStringList text = pstats::overlayText();
+  if(text.isEmpty())
+    return;
+
+  if(OptionData::instance().getFlags2() & opts::MAP_ADAPTIVE_DETAIL)
+    text.insert(1, QString("Detail reduction level %1 of %2").
+                arg(detailGovernor->getLevel()).arg(MapDetailGovernor::MAX_LEVEL));
+
+  atools::util::PainterContextSaver saver(painter);
+  Q_UNUSED(saver);
+
+  QFont font = painter->font();
+  font.setBold(false);
+  painter->setFont(font);
+  QFontMetrics metrics = painter->fontMetrics();
+
+  int width = 0;
+  for(const QString& line : text)
+    width = std::max(width, metrics.width(line));
+
+  // Draw semi-transparent box into the top left corner
+  QRect rect(10, 10, width + 10, metrics.height() * text.size() + 10);
+  painter->setPen(Qt::black);
+  painter->setBrush(QColor(255, 255, 255, 200));
+  painter->drawRect(rect);
+
+  int y = rect.top() + 5 + metrics.ascent();
+  for(const QString& line : text)
+  {
+    painter->drawText(rect.left() + 5, y, line);
+    y += metrics.height();
+  }
+}
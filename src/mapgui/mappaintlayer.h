@@ -20,6 +20,7 @@
 
 #include "mapgui/mappainter.h"
 
+#include <QImage>
 #include <QPen>
 
 #include <marble/LayerInterface.h>
@@ -45,6 +46,7 @@ class MapPainterAircraft;
 class MapPainterShip;
 class MapPainterUser;
 class MapPainterAltitude;
+class MapDetailGovernor;
 
 /*
  * Implements the Marble layer interface that paints upon the Marble map. Contains all painter instances
@@ -61,6 +63,9 @@ public:
   void preDatabaseLoad();
   void postDatabaseLoad();
 
+  /* Enables or disables paint statistics */
+  void optionsChanged();
+
   /* Get the current map layer for the zoom distance and detail level */
   const MapLayer *getMapLayer() const
   {
@@ -101,11 +106,18 @@ public:
     return mapScale;
   }
 
+  /* Number of map objects that were omitted in the last paint event */
   int getOverflow() const
   {
     return overflow;
   }
 
+  /* Object types that were thinned out in the last paint event like "waypoints, airways" */
+  QString getOverflowText() const
+  {
+    return objectBudget.getThinnedText();
+  }
+
   map::MapWeatherSource getWeatherSource() const
   {
     return weatherSource;
@@ -114,6 +126,7 @@ public:
   void setWeatherSource(const map::MapWeatherSource& value)
   {
     weatherSource = value;
+    invalidateStaticLayer();
   }
 
   map::MapSunShading getSunShading() const
@@ -126,10 +139,52 @@ public:
     sunShading = value;
   }
 
+  /* Forces a repaint of the cached static layer (airspaces, navaids, airports, userpoints) on the next render.
+   * Has to be called whenever data, options or the route change. Changes of the viewport are detected automatically. */
+  void invalidateStaticLayer()
+  {
+    staticLayerValid = false;
+  }
+
 private:
   void initMapLayerSettings();
   void updateLayers();
 
+  /* Paint airspaces, ILS, navaids, airports and userpoints in the right order */
+  void renderStaticPainters(PaintContext *context);
+
+  /* Collect the number of objects from all static painters and distribute the maximum number of objects
+   * by priority */
+  void planObjectBudget(PaintContext *context);
+
+  /* Paint ILS, navaids, airports and userpoints in the right order */
+  void renderNavaidPainters(PaintContext *context);
+
+  /* Paint altitude grid and airspaces into separate images using worker threads while navaids, airports and
+   * userpoints are painted into a third image in the main thread. Images are merged in the same order as
+   * the sequential painting. Altitude grid is left out if paintAltitude is false.
+   * Ship is painted between altitude grid and airspaces if paintShip is true. */
+  void renderStaticPaintersParallel(PaintContext *context, bool paintAltitude, bool paintShip);
+
+  /* Call render of painter and collect time and number of objects if statistics are enabled */
+  void renderPainter(MapPainter *mapPainter, PaintContext *context, const char *name);
+
+  /* Draw frame time, time per painter and cache misses into the top left corner */
+  void paintStatisticsOverlay(Marble::GeoPainter *painter);
+
+  /* Option for parallel painting enabled and not printing */
+  bool useParallelRendering() const;
+
+  /* Resize image if needed and fill it transparent */
+  void initLayerImage(QImage& image, const Marble::ViewportParams *viewport) const;
+
+  /* Paint altitude grid and all static painters into the image cache if the viewport or data has changed
+   * and copy the images on the map with ships painted in between. Returns true if the images were painted again. */
+  bool renderStaticLayerCached(PaintContext *context);
+
+  /* true if cached image is valid for the given viewport */
+  bool isStaticLayerCurrent(const Marble::ViewportParams *viewport) const;
+
   /* Implemented from LayerInterface: We  draw above all but below user tools */
   virtual QStringList renderPosition() const override
   {
@@ -164,6 +219,12 @@ private:
   MapPainterUser *mapPainterUser;
   MapPainterAltitude *mapPainterAltitude;
 
+  /* Number of objects per type that can be drawn by the static painters */
+  MapPaintBudget objectBudget;
+
+  /* Reduces details if painting is too slow */
+  MapDetailGovernor *detailGovernor = nullptr;
+
   /* Database source */
   MapQuery *mapQuery = nullptr;
 
@@ -173,6 +234,25 @@ private:
   const MapLayer *mapLayer = nullptr, *mapLayerEffective = nullptr;
   int overflow = 0;
 
+  /* Offscreen images of all static painters. Used while connected and the map is still to avoid
+   * painting all map objects again on each simulator update. Altitude grid is kept separately since
+   * ships are painted between it and the other static objects. */
+  QImage staticLayerImage, staticLayerAltitudeImage;
+  bool staticLayerValid = false;
+
+  /* Number of objects painted into the cached image to allow the overflow check */
+  int staticLayerObjectCount = 0;
+
+  /* Viewport values at the time the image was painted */
+  QSize staticLayerSize;
+  qreal staticLayerDevicePixelRatio = 1.;
+  int staticLayerRadius = 0;
+  qreal staticLayerCenterLon = 0., staticLayerCenterLat = 0.;
+  Marble::Projection staticLayerProjection = Marble::Spherical;
+
+  /* Layer images used by parallel painting. Kept to avoid reallocation on each frame. */
+  QImage layerImageAltitude, layerImageAirspace, layerImageNavaid;
+
 };
 
 #endif // LITTLENAVMAP_MAPPAINTLAYER_H
@@ -46,7 +46,8 @@ using Marble::GeoDataLineString;
 using Marble::GeoDataCoordinates;
 
 MapScreenIndex::MapScreenIndex(MapWidget *parentWidget, MapPaintLayer *mapPaintLayer)
-  : mapWidget(parentWidget), paintLayer(mapPaintLayer)
+  : simData(simdata::emptySnapshot()), lastSimData(simdata::emptySnapshot()), mapWidget(parentWidget),
+  paintLayer(mapPaintLayer)
 {
   mapQuery = NavApp::getMapQuery();
   airspaceQuery = NavApp::getAirspaceQuery();
@@ -320,7 +321,7 @@ void MapScreenIndex::getAllNearest(int xs, int ys, int maxDistance, map::MapSear
   result.userAircraft = atools::fs::sc::SimConnectUserAircraft();
   if(shown & map::AIRCRAFT && NavApp::isConnectedAndAircraft())
   {
-    const atools::fs::sc::SimConnectUserAircraft& user = simData.getUserAircraftConst();
+    const atools::fs::sc::SimConnectUserAircraft& user = simData->getUserAircraftConst();
     int x, y;
     if(conv.wToS(user.getPosition(), x, y))
     {
@@ -338,7 +339,7 @@ void MapScreenIndex::getAllNearest(int xs, int ys, int maxDistance, map::MapSear
   {
     if(shown & map::AIRCRAFT_AI_SHIP && mapLayer->isAiShipLarge())
     {
-      for(const atools::fs::sc::SimConnectAircraft& obj : simData.getAiAircraftConst())
+      for(const atools::fs::sc::SimConnectAircraft& obj : simData->getAiAircraftConst())
       {
         if(obj.getCategory() == atools::fs::sc::BOAT &&
            (obj.getModelRadiusCorrected() * 2 > layer::LARGE_SHIP_SIZE || mapLayer->isAiShipSmall()))
@@ -18,6 +18,7 @@
 #ifndef LITTLENAVMAP_MAPSCREENINDEX_H
 #define LITTLENAVMAP_MAPSCREENINDEX_H
 
+#include "connect/simdatasnapshot.h"
 #include "fs/sc/simconnectdata.h"
 
 #include "route/route.h"
@@ -157,32 +158,40 @@ public:
 
   const atools::fs::sc::SimConnectUserAircraft& getUserAircraft()
   {
-    return simData.getUserAircraftConst();
+    return simData->getUserAircraftConst();
   }
 
   const atools::fs::sc::SimConnectUserAircraft& getLastUserAircraft()
   {
-    return lastSimData.getUserAircraftConst();
+    return lastSimData->getUserAircraftConst();
+  }
+
+  /* Snapshot of the last significant update. Hold a reference to keep aircraft of it valid
+   * across calls to updateLastSimData. */
+  const SimConnectDataPtr& getLastSimData() const
+  {
+    return lastSimData;
   }
 
   const QVector<atools::fs::sc::SimConnectAircraft>& getAiAircraft()
   {
-    return simData.getAiAircraftConst();
+    return simData->getAiAircraftConst();
   }
 
-  void updateSimData(const atools::fs::sc::SimConnectData& data)
+  /* Keeps a reference to the shared snapshot. Resets to empty data if data is null. */
+  void updateSimData(const SimConnectDataPtr& data)
   {
-    simData = data;
+    simData = data.isNull() ? simdata::emptySnapshot() : data;
   }
 
   bool isUserAircraftValid() const
   {
-    return simData.getUserAircraftConst().getPosition().isValid();
+    return simData->getUserAircraftConst().getPosition().isValid();
   }
 
-  void updateLastSimData(const atools::fs::sc::SimConnectData& data)
+  void updateLastSimData(const SimConnectDataPtr& data)
   {
-    lastSimData = data;
+    lastSimData = data.isNull() ? simdata::emptySnapshot() : data;
   }
 
   const proc::MapProcedureLegs& getProcedureHighlight() const
@@ -232,7 +241,8 @@ private:
   template<typename TYPE>
   int getNearestIndex(int xs, int ys, int maxDistance, const QList<TYPE>& typeList);
 
-  atools::fs::sc::SimConnectData simData, lastSimData;
+  /* Shared with all other receivers of the sim data. Never null. */
+  SimConnectDataPtr simData, lastSimData;
   MapWidget *mapWidget;
   MapQuery *mapQuery;
   AirspaceQuery *airspaceQuery;
@@ -89,9 +89,6 @@ const static QHash<opts::SimUpdateRate, MapWidget::SimUpdateDelta> SIM_UPDATE_DE
   }
 });
 
-/* Update rate on tooltip for bearing display */
-const int MAX_SIM_UPDATE_TOOLTIP_MS = 500;
-
 const static double MINIMUM_DISTANCE = 0.1;
 const static double MAXIMUM_DISTANCE = 6000.;
 const static double DISTANCE_EPSILON = 0.00001;
@@ -269,13 +266,22 @@ void MapWidget::optionsChanged()
   setSunShadingDimFactor(static_cast<double>(OptionData::instance().getDisplaySunShadingDimFactor()) / 100.);
   setShowSunShading(showSunShading());
 
+  // Track buffer can be resized without losing the latest positions
+  int trackSize = aircraftTrack.size();
+  aircraftTrack.setMaxTrackEntries(OptionData::instance().getAircraftTrackMaxPoints());
+  if(trackSize != aircraftTrack.size())
+    emit aircraftTrackPruned();
+
   // reloadMap();
   updateCacheSizes();
+  paintLayer->optionsChanged();
+  paintLayer->invalidateStaticLayer();
   update();
 }
 
 void MapWidget::styleChanged()
 {
+  paintLayer->invalidateStaticLayer();
   update();
 }
 
@@ -399,7 +405,10 @@ void MapWidget::updateSunShadingOption()
 void MapWidget::weatherUpdated()
 {
   if(paintLayer->getShownMapObjects() | map::AIRPORT_WEATHER)
+  {
+    paintLayer->invalidateStaticLayer();
     update();
+  }
 }
 
 map::MapWeatherSource MapWidget::getMapWeatherSource() const
@@ -779,9 +788,10 @@ void MapWidget::restoreState()
     kmlFilePaths = s.valueStrList(lnm::MAP_KMLFILES);
   screenIndex->restoreState();
 
+  // Set size first to read only the needed positions
+  aircraftTrack.setMaxTrackEntries(OptionData::instance().getAircraftTrackMaxPoints());
   if(OptionData::instance().getFlags() & opts::STARTUP_LOAD_TRAIL)
     aircraftTrack.restoreState();
-  aircraftTrack.setMaxTrackEntries(OptionData::instance().getAircraftTrackMaxPoints());
 
   atools::gui::WidgetState state(lnm::MAP_OVERLAY_VISIBLE, false /*save visibility*/, true /*block signals*/);
   for(QAction *action : mapOverlays.values())
@@ -1166,6 +1176,7 @@ void MapWidget::routeChanged(bool geometryChanged)
   {
     cancelDragAll();
     screenIndex->updateRouteScreenGeometry(currentViewBoundingBox);
+    paintLayer->invalidateStaticLayer();
     update();
   }
 }
@@ -1179,6 +1190,7 @@ void MapWidget::routeAltitudeChanged(float altitudeFeet)
 
   qDebug() << Q_FUNC_INFO;
   screenIndex->updateAirspaceScreenGeometry(currentViewBoundingBox);
+  paintLayer->invalidateStaticLayer();
   update();
 }
 
@@ -1189,9 +1201,9 @@ bool MapWidget::isCenterLegAndAircraftActive()
          !route.isEmpty() && route.isActiveValid() && screenIndex->getUserAircraft().isFlying();
 }
 
-void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorData)
+void MapWidget::simDataChanged(const SimConnectDataPtr& simulatorData)
 {
-  const atools::fs::sc::SimConnectUserAircraft& aircraft = simulatorData.getUserAircraftConst();
+  const atools::fs::sc::SimConnectUserAircraft& aircraft = simulatorData->getUserAircraftConst();
   if(databaseLoadStatus || !aircraft.isValid())
     return;
 
@@ -1200,7 +1212,10 @@ void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorDa
     setSunShadingDateTime(aircraft.getZuluTime());
 
   screenIndex->updateSimData(simulatorData);
-  const atools::fs::sc::SimConnectUserAircraft& last = screenIndex->getLastUserAircraft();
+
+  // Keep the last snapshot alive since updateLastSimData below might release it
+  SimConnectDataPtr lastSimData = screenIndex->getLastSimData();
+  const atools::fs::sc::SimConnectUserAircraft& last = lastSimData->getUserAircraftConst();
 
   // Calculate travel distance since last takeoff event ===================================
   if(!takeoffLandingLastAircraft.isValid())
@@ -1280,19 +1295,7 @@ void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorDa
     // We have a track - update toolbar and menu
     emit updateActionStates();
 
-  // ================================================================================
-  // Update tooltip for bearing
   qint64 now = QDateTime::currentMSecsSinceEpoch();
-  if(now - lastSimUpdateTooltipMs > MAX_SIM_UPDATE_TOOLTIP_MS)
-  {
-    lastSimUpdateTooltipMs = now;
-    if((mapSearchResultTooltip.hasAirports() || mapSearchResultTooltip.hasVor() || mapSearchResultTooltip.hasNdb() ||
-        mapSearchResultTooltip.hasWaypoints() || mapSearchResultTooltip.hasUserpoints()) &&
-       NavApp::isConnectedAndAircraft())
-    {
-      updateTooltip();
-    }
-  }
 
   // ================================================================================
   // Check if screen has to be updated/scrolled/zoomed
@@ -1317,7 +1320,7 @@ void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorDa
          paintLayer->getShownMapObjects() & map::AIRCRAFT_AI_SHIP ||
          paintLayer->getShownMapObjects() & map::AIRCRAFT_ONLINE)
       {
-        for(const atools::fs::sc::SimConnectAircraft& ai : simulatorData.getAiAircraftConst())
+        for(const atools::fs::sc::SimConnectAircraft& ai : simulatorData->getAiAircraftConst())
         {
           if(currentViewBoundingBox.contains(
                Marble::GeoDataCoordinates(ai.getPosition().getLonX(), ai.getPosition().getLatY(), 0,
@@ -1499,6 +1502,20 @@ void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorDa
   }
 }
 
+void MapWidget::simDataChangedTooltip(const SimConnectDataPtr& simulatorData)
+{
+  if(databaseLoadStatus || !simulatorData->getUserAircraftConst().isValid())
+    return;
+
+  // Update tooltip for bearing
+  if((mapSearchResultTooltip.hasAirports() || mapSearchResultTooltip.hasVor() || mapSearchResultTooltip.hasNdb() ||
+      mapSearchResultTooltip.hasWaypoints() || mapSearchResultTooltip.hasUserpoints()) &&
+     NavApp::isConnectedAndAircraft())
+  {
+    updateTooltip();
+  }
+}
+
 void MapWidget::highlightProfilePoint(const atools::geo::Pos& pos)
 {
   changeProfileHighlight(pos);
@@ -1515,7 +1532,7 @@ void MapWidget::disconnectedFromSimulator()
 {
   qDebug() << Q_FUNC_INFO;
   // Clear all data on disconnect
-  screenIndex->updateSimData(atools::fs::sc::SimConnectData());
+  screenIndex->updateSimData(simdata::emptySnapshot());
   mapVisible->updateVisibleObjectsStatusBar();
   jumpBackToAircraftCancel();
   update();
@@ -2970,7 +2987,7 @@ void MapWidget::debugMovingPlane(QMouseEvent *event)
       atools::fs::sc::SimConnectData data = atools::fs::sc::SimConnectData::buildDebugForPosition(pos, lastPos);
       data.setPacketId(packetId++);
 
-      emit NavApp::getConnectClient()->dataPacketReceived(data);
+      emit NavApp::getConnectClient()->dataPacketReceived(simdata::createSnapshot(std::move(data)));
       lastPos = pos;
       lastPoint = event->pos();
     }
@@ -3608,7 +3625,7 @@ void MapWidget::paintEvent(QPaintEvent *paintEvent)
   }
 
   if(paintLayer->getOverflow() > 0)
-    emit resultTruncated(paintLayer->getOverflow());
+    emit resultTruncated(paintLayer->getOverflow(), paintLayer->getOverflowText());
 }
 
 void MapWidget::handleInfoClick(QPoint pos)
@@ -3709,6 +3726,7 @@ void MapWidget::setMapDetail(int factor)
 void MapWidget::onlineClientAndAtcUpdated()
 {
   screenIndex->updateAirspaceScreenGeometry(currentViewBoundingBox);
+  paintLayer->invalidateStaticLayer();
   update();
 }
 
@@ -3716,6 +3734,7 @@ void MapWidget::onlineNetworkChanged()
 {
   screenIndex->resetAirspaceOnlineScreenGeometry();
   screenIndex->updateAirspaceScreenGeometry(currentViewBoundingBox);
+  paintLayer->invalidateStaticLayer();
   update();
 }
 
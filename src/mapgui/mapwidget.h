@@ -20,6 +20,7 @@
 
 #include "common/maptypes.h"
 #include "gui/mapposhistory.h"
+#include "connect/simdatasnapshot.h"
 #include "fs/sc/simconnectdata.h"
 #include "common/aircrafttrack.h"
 
@@ -137,7 +138,13 @@ public:
   void routeAltitudeChanged(float altitudeFeet);
 
   /* New data from simconnect has arrived. Update aircraft position and track. */
-  void simDataChanged(const atools::fs::sc::SimConnectData& simulatorData);
+  void simDataChanged(const SimConnectDataPtr& simulatorData);
+
+  /* Update rate on tooltip for bearing display. Used by the sim data dispatcher. */
+  static Q_DECL_CONSTEXPR int MAX_SIM_UPDATE_TOOLTIP_MS = 500;
+
+  /* Update bearing in tooltip. Called at most every MAX_SIM_UPDATE_TOOLTIP_MS. */
+  void simDataChangedTooltip(const SimConnectDataPtr& simulatorData);
 
   /* Hightlight a point along the route while mouse over in the profile window */
   void highlightProfilePoint(const atools::geo::Pos& pos);
@@ -343,8 +350,9 @@ public:
   }
 
 signals:
-  /* Emitted whenever the result exceeds the limit clause in the queries */
-  void resultTruncated(int truncatedTo);
+  /* Emitted whenever not all map objects could be drawn. thinnedTypes is a list of object types which were
+   * thinned out like "waypoints, airways". */
+  void resultTruncated(int numOmitted, const QString& thinnedTypes);
 
   /* Search center has changed by context menu */
   void searchMarkChanged(const atools::geo::Pos& mark);
@@ -538,7 +546,6 @@ private:
   /* Used to check for simulator aircraft updates */
   qint64 lastSimUpdateMs = 0L;
   qint64 lastCenterAcAndWp = 0L;
-  qint64 lastSimUpdateTooltipMs = 0L;
   bool active = false;
 
   /* Delay display of elevation display to avoid lagging mouse movements */
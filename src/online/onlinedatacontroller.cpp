@@ -27,6 +27,11 @@
 #include "gui/dialog.h"
 #include "geo/calculations.h"
 #include "sql/sqlquery.h"
+#include "sql/sqldatabase.h"
+#include "sql/sqlrecord.h"
+#include "sql/sqlutil.h"
+#include "exception.h"
+#include "db/databasemanager.h"
 #include "mapgui/maplayer.h"
 #include "fs/sc/simconnectuseraircraft.h"
 #include "navapp.h"
@@ -35,11 +40,18 @@
 #include <QMessageBox>
 #include <QTextCodec>
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <atomic>
 
 // #define DEBUG_ONLINE_DOWNLOAD 1
 
 static const int MIN_SERVER_DOWNLOAD_INTERVAL_MIN = 15;
 
+/* Used to build unique connection names for the shadow database */
+static std::atomic_int shadowConnectionCounter(0);
+
 // Remove if duplicates with same registration if they are this close (500 kts for 3 min)
 #ifdef DEBUG_INFORMATION
 static const int MIN_DISTANCE_DUPLICATE_M = atools::geo::nmToMeter(900);
@@ -51,6 +63,8 @@ using atools::fs::sc::SimConnectAircraft;
 using atools::fs::online::OnlinedataManager;
 using atools::util::HttpDownloader;
 using atools::geo::Pos;
+using atools::sql::SqlDatabase;
+using atools::sql::SqlQuery;
 
 atools::fs::online::Format convertFormat(opts::OnlineFormat format)
 {
@@ -83,6 +97,9 @@ OnlinedataController::OnlinedataController(atools::fs::online::OnlinedataManager
   // Recurring downloads
   connect(&downloadTimer, &QTimer::timeout, this, &OnlinedataController::startDownloadInternal);
 
+  // Decompressed and decoded whazzup.txt is ready
+  connect(&whazzupWatcher, &QFutureWatcher<WhazzupResult>::finished, this, &OnlinedataController::whazzupDecoded);
+
 #ifdef DEBUG_ONLINE_DOWNLOAD
   downloader->enableCache(60);
 #endif
@@ -90,6 +107,10 @@ OnlinedataController::OnlinedataController(atools::fs::online::OnlinedataManager
 
 OnlinedataController::~OnlinedataController()
 {
+  // Ignore any result from a running decoding thread
+  whazzupWatcher.disconnect();
+  whazzupFuture.waitForFinished();
+
   deInitQueries();
 
   delete downloader;
@@ -140,6 +161,9 @@ void OnlinedataController::updateAtcSizes()
     sizeMap.insert(type, diameter != -1 ? std::max(1, diameter / 2) : -1);
   }
   manager->setAtcSize(sizeMap);
+
+  // Needed for the manager of the shadow database too
+  atcSizes = sizeMap;
 }
 
 void OnlinedataController::startProcessing()
@@ -240,79 +264,233 @@ void OnlinedataController::downloadFinished(const QByteArray& data, QString url)
   }
   else if(currentState == DOWNLOADING_WHAZZUP)
   {
-    QByteArray whazzupData;
+    // An outdated job might still write into the shadow database after stopAllProcesses
+    whazzupFuture.waitForFinished();
+
+    WhazzupJob job;
+    job.data = data;
+    job.gzipped = whazzupGzipped;
+    job.codec = codec;
+    job.format = convertFormat(OptionData::instance().getOnlineFormat());
+    job.lastUpdateTime = whazzupLastUpdateTime;
+    job.atcSizes = atcSizes;
+    job.databaseFile = NavApp::getDatabaseManager()->getOnlineDatabaseShadowFile();
+    job.activeDatabaseFile = getDatabase()->databaseName();
+
+    // Decompress, decode and parse the large file into the shadow database in the background.
+    // Result is processed in whazzupDecoded.
+    currentState = DECODING_WHAZZUP;
+    whazzupFuture = QtConcurrent::run(&OnlinedataController::parseWhazzup, job);
+    whazzupWatcher.setFuture(whazzupFuture);
+  }
+  else if(currentState == DOWNLOADING_WHAZZUP_SERVERS)
+  {
+    manager->readServersFromWhazzup(codec->toUnicode(data),
+                                    convertFormat(OptionData::instance().getOnlineFormat()),
+                                    whazzupLastUpdateTime);
+    lastServerDownload = QDateTime::currentDateTime();
 
-    if(whazzupGzipped)
-    {
-      if(!atools::zip::gzipDecompress(data, whazzupData))
-        qWarning() << Q_FUNC_INFO << "Error unzipping data";
-    }
-    else
-      whazzupData = data;
+    // Done after downloading server.txt - start timer for next session
+    startDownloadTimer();
+    currentState = NONE;
+    lastUpdateTime = QDateTime::currentDateTime();
 
-    if(manager->readFromWhazzup(codec->toUnicode(whazzupData),
-                                convertFormat(OptionData::instance().getOnlineFormat()),
-                                manager->getLastUpdateTimeFromWhazzup()))
+    // Clients and ATC were already sent after swapping the database
+    emit onlineServersUpdated(true /* load all */, true /* keep selection */);
+    statusBarMessage();
+  }
+}
+
+QString OnlinedataController::decodeWhazzup(QByteArray data, bool gzipped, QTextCodec *textCodec)
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  QByteArray whazzupData;
+  if(gzipped)
+  {
+    if(!atools::zip::gzipDecompress(data, whazzupData))
+      qWarning() << Q_FUNC_INFO << "Error unzipping data";
+  }
+  else
+    whazzupData = data;
+
+  QString whazzup = textCodec->toUnicode(whazzupData);
+
+  qDebug() << Q_FUNC_INFO << "Decoded" << whazzup.size() << "characters in" << timer.elapsed() << "ms";
+  return whazzup;
+}
+
+OnlinedataController::WhazzupResult OnlinedataController::parseWhazzup(WhazzupJob job)
+{
+  WhazzupResult result;
+  QString whazzup = decodeWhazzup(job.data, job.gzipped, job.codec);
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // Connections cannot be used across threads - use an own one for each run
+  QString connectionName = QString("LNMDBONLINESHADOW%1").arg(shadowConnectionCounter++);
+  SqlDatabase::addDatabase("QSQLITE", connectionName);
+  {
+    SqlDatabase db(connectionName);
+    try
     {
-      // Get all callsigns and positions from online list to allow deduplication
-      manager->getClientCallsignAndPosMap(clientCallsignAndPosMap);
+      db.setDatabaseName(job.databaseFile);
+      db.setAutomaticTransactions(false);
 
-      QString whazzupVoiceUrlFromStatus = manager->getWhazzupVoiceUrlFromStatus();
-      if(!whazzupVoiceUrlFromStatus.isEmpty() &&
-         lastServerDownload < QDateTime::currentDateTime().addSecs(-MIN_SERVER_DOWNLOAD_INTERVAL_MIN * 60))
-      {
-        // Next in chain is server file
-        currentState = DOWNLOADING_WHAZZUP_SERVERS;
-        downloader->setUrl(whazzupVoiceUrlFromStatus);
+      // Database is filled from scratch for each update - no need to sync
+      db.open({"PRAGMA locking_mode=NORMAL", "PRAGMA journal_mode=DELETE", "PRAGMA synchronous=OFF",
+               "PRAGMA busy_timeout=2000"});
 
-        // Call later in the event loop to avoid recursion
-        QTimer::singleShot(0, downloader, &HttpDownloader::startDownload);
-      }
-      else
+      // Drops and creates all tables
+      OnlinedataManager shadowManager(&db);
+      shadowManager.createSchema();
+      shadowManager.initQueries();
+      shadowManager.setAtcSize(job.atcSizes);
+
+      result.updated = shadowManager.readFromWhazzup(whazzup, job.format, job.lastUpdateTime);
+      if(result.updated)
       {
-        // Done after downloading whazzup.txt - start timer for next session
-        startDownloadTimer();
-        currentState = NONE;
-        lastUpdateTime = QDateTime::currentDateTime();
+        result.lastUpdateTime = shadowManager.getLastUpdateTimeFromWhazzup();
+        result.reloadMinutes = shadowManager.getReloadMinutesFromWhazzup();
 
-        aircraftCache.clear();
-        simulatorAiRegistrations.clear();
+        // Get all callsigns and positions from online list to allow deduplication
+        shadowManager.getClientCallsignAndPosMap(result.clientCallsignAndPosMap);
 
-        // Message for search tabs, map widget and info
-        emit onlineClientAndAtcUpdated(true /* load all */, true /* keep selection */);
-        statusBarMessage();
+        if(atools::sql::SqlUtil(&db).rowCount("server") == 0)
+          copyServers(db, job.activeDatabaseFile);
       }
+
+      shadowManager.deInitQueries();
+      db.close();
     }
-    else
+    catch(atools::Exception& e)
+    {
+      // Error dialogs cannot be shown in this thread - keep the current data
+      qWarning() << Q_FUNC_INFO << "Cannot write" << job.databaseFile << ":" << e.what();
+      result.updated = false;
+    }
+    catch(...)
     {
-      qInfo() << Q_FUNC_INFO << "whazzup.txt is not recent";
+      qWarning() << Q_FUNC_INFO << "Cannot write" << job.databaseFile;
+      result.updated = false;
+    }
+  }
+  SqlDatabase::removeDatabase(connectionName);
+
+  qDebug() << Q_FUNC_INFO << "Parsed into" << job.databaseFile << "in" << timer.elapsed() << "ms";
+  return result;
+}
+
+void OnlinedataController::copyServers(SqlDatabase& db, const QString& activeDatabaseFile)
+{
+  // Servers are downloaded less often than whazzup.txt - keep the ones from the last download
+  QString connectionName = QString("LNMDBONLINESHADOW%1").arg(shadowConnectionCounter++);
+  SqlDatabase::addDatabase("QSQLITE", connectionName);
+  {
+    SqlDatabase activeDb(connectionName);
+    activeDb.setDatabaseName(activeDatabaseFile);
+    activeDb.setReadonly(true);
+    activeDb.open({"PRAGMA busy_timeout=2000"});
+
+    SqlQuery select("select * from server", &activeDb);
+    select.exec();
 
-      // Done after old update - try again later
+    atools::sql::SqlRecord record = select.record();
+    QStringList columns, placeholders;
+    for(int i = 0; i < record.count(); i++)
+    {
+      columns.append(record.fieldName(i));
+      placeholders.append(":" + record.fieldName(i));
+    }
+
+    SqlQuery insert(&db);
+    insert.prepare("insert into server (" + columns.join(", ") + ") values(" + placeholders.join(", ") + ")");
+
+    while(select.next())
+    {
+      for(int i = 0; i < record.count(); i++)
+        insert.bindValue(placeholders.at(i), select.value(i));
+      insert.exec();
+    }
+    db.commit();
+
+    select.finish();
+    activeDb.close();
+  }
+  SqlDatabase::removeDatabase(connectionName);
+}
+
+void OnlinedataController::whazzupDecoded()
+{
+  if(currentState != DECODING_WHAZZUP)
+  {
+    // Processes were stopped while decoding
+    qDebug() << Q_FUNC_INFO << "Ignoring outdated whazzup.txt";
+    return;
+  }
+
+  WhazzupResult result = whazzupFuture.result();
+
+  // Shadow database is complete. Signals are sent only after switching to it.
+  if(result.updated)
+  {
+    whazzupLastUpdateTime = result.lastUpdateTime;
+    whazzupReloadMinutes = result.reloadMinutes;
+    clientCallsignAndPosMap = result.clientCallsignAndPosMap;
+
+    swapDatabase();
+
+    // Caches refer to the old database
+    aircraftCache.clear();
+    simulatorAiRegistrations.clear();
+
+    // Message for search tabs, map widget and info
+    emit onlineClientAndAtcUpdated(true /* load all */, true /* keep selection */);
+
+    QString whazzupVoiceUrlFromStatus = manager->getWhazzupVoiceUrlFromStatus();
+    if(!whazzupVoiceUrlFromStatus.isEmpty() &&
+       lastServerDownload < QDateTime::currentDateTime().addSecs(-MIN_SERVER_DOWNLOAD_INTERVAL_MIN * 60))
+    {
+      // Next in chain is server file
+      currentState = DOWNLOADING_WHAZZUP_SERVERS;
+      downloader->setUrl(whazzupVoiceUrlFromStatus);
+
+      // Call later in the event loop to avoid recursion
+      QTimer::singleShot(0, downloader, &HttpDownloader::startDownload);
+    }
+    else
+    {
+      // Done after downloading whazzup.txt - start timer for next session
       startDownloadTimer();
       currentState = NONE;
       lastUpdateTime = QDateTime::currentDateTime();
+      statusBarMessage();
     }
   }
-  else if(currentState == DOWNLOADING_WHAZZUP_SERVERS)
+  else
   {
-    manager->readServersFromWhazzup(codec->toUnicode(data),
-                                    convertFormat(OptionData::instance().getOnlineFormat()),
-                                    manager->getLastUpdateTimeFromWhazzup());
-    lastServerDownload = QDateTime::currentDateTime();
+    qInfo() << Q_FUNC_INFO << "whazzup.txt is not recent";
 
-    // Done after downloading server.txt - start timer for next session
+    // Done after old update - try again later
     startDownloadTimer();
     currentState = NONE;
     lastUpdateTime = QDateTime::currentDateTime();
+  }
+}
 
-    aircraftCache.clear();
-    simulatorAiRegistrations.clear();
+void OnlinedataController::swapDatabase()
+{
+  // Delete all queries before closing the connection
+  deInitQueries();
+  NavApp::getAirspaceQueryOnline()->deInitQueries();
 
-    // Message for search tabs, map widget and info
-    emit onlineClientAndAtcUpdated(true /* load all */, true /* keep selection */);
-    emit onlineServersUpdated(true /* load all */, true /* keep selection */);
-    statusBarMessage();
-  }
+  NavApp::getDatabaseManager()->swapOnlineDatabase();
+
+  // Search models reopen their read-only connections since the file name has changed
+  NavApp::getAirspaceQueryOnline()->initQueries();
+  initQueries();
 }
 
 void OnlinedataController::downloadFailed(const QString& error, QString url)
@@ -357,6 +535,8 @@ void OnlinedataController::optionsChanged()
   manager->resetForNewOptions();
   stopAllProcesses();
   whazzupGzipped = false;
+  whazzupLastUpdateTime = QDateTime();
+  whazzupReloadMinutes = 0;
 
   // Remove all from the database
   manager->clearData();
@@ -606,7 +786,7 @@ void OnlinedataController::startDownloadTimer()
     if(reloadFromCfg == -1)
     {
       // Use time from whazzup.txt - mode auto
-      intervalSeconds = std::max(manager->getReloadMinutesFromWhazzup() * 60, 60);
+      intervalSeconds = std::max(whazzupReloadMinutes * 60, 60);
       source = "whazzup";
     }
     else
@@ -19,9 +19,12 @@
 #define LNM_ONLINECONTROLLER_H
 
 #include <QDateTime>
+#include <QFuture>
+#include <QFutureWatcher>
 #include <QObject>
 #include <QTimer>
 
+#include "fs/online/onlinedatamanager.h"
 #include "query/querytypes.h"
 
 class MapLayer;
@@ -47,9 +50,6 @@ namespace fs {
 namespace sc {
 class SimConnectAircraft;
 }
-namespace online {
-class OnlinedataManager;
-}
 }
 }
 
@@ -144,6 +144,44 @@ private:
   void downloadFailed(const QString& error, QString url);
   void statusBarMessage();
 
+  /* Input for parseWhazzup */
+  struct WhazzupJob
+  {
+    QByteArray data;
+    bool gzipped = false;
+    QTextCodec *codec = nullptr;
+    atools::fs::online::Format format = atools::fs::online::UNKNOWN;
+    QDateTime lastUpdateTime; /* Last update time of the previous whazzup.txt */
+    QHash<atools::fs::online::fac::FacilityType, int> atcSizes;
+    QString databaseFile, /* Shadow database file to write into */
+            activeDatabaseFile; /* File currently used by the online database connection */
+  };
+
+  /* Result of parseWhazzup */
+  struct WhazzupResult
+  {
+    bool updated = false; /* False if the file was not more recent than the last one or on error */
+    QDateTime lastUpdateTime;
+    int reloadMinutes = 0;
+    QHash<QString, atools::geo::Pos> clientCallsignAndPosMap;
+  };
+
+  /* Decompress if needed and convert whazzup.txt to text. Called in a background thread. */
+  static QString decodeWhazzup(QByteArray data, bool gzipped, QTextCodec *textCodec);
+
+  /* Decode whazzup.txt and write it into the shadow database file using an own connection and
+   * OnlinedataManager. Called in a background thread. */
+  static WhazzupResult parseWhazzup(WhazzupJob job);
+
+  /* Copy servers from the active database file if the new whazzup.txt did not contain any */
+  static void copyServers(atools::sql::SqlDatabase& db, const QString& activeDatabaseFile);
+
+  /* Called in the main thread when parseWhazzup is done. Swaps databases and sends signals. */
+  void whazzupDecoded();
+
+  /* Switch the online database connection to the shadow file. Prepares all online queries again. */
+  void swapDatabase();
+
   void startDownloadInternal();
   void startDownloadTimer();
   void stopAllProcesses();
@@ -161,6 +199,7 @@ private:
     NONE, /* Not downloading anything */
     DOWNLOADING_STATUS, /* Downloading status.txt */
     DOWNLOADING_WHAZZUP, /* Downloading whazzup.txt */
+    DECODING_WHAZZUP, /* Decompressing, decoding and parsing whazzup.txt in background */
     DOWNLOADING_WHAZZUP_SERVERS /* Downloading servers */
   };
 
@@ -174,11 +213,22 @@ private:
   /*  Last update from whazzup */
   QDateTime lastUpdateTime;
 
+  /* Values from the last parsed whazzup.txt. Kept here since it is parsed by the manager of the shadow database. */
+  QDateTime whazzupLastUpdateTime;
+  int whazzupReloadMinutes = 0;
+
+  /* Circle radius for ATC centers from options */
+  QHash<atools::fs::online::fac::FacilityType, int> atcSizes;
+
   /* Set after parsing status.txt to indicate compressed file */
   bool whazzupGzipped = false;
 
   QTextCodec *codec = nullptr;
 
+  /* Decodes and parses whazzup.txt in background */
+  QFuture<WhazzupResult> whazzupFuture;
+  QFutureWatcher<WhazzupResult> whazzupWatcher;
+
   /* Simulator aircraft registrations and positions */
   QHash<QString, atools::geo::Pos> simulatorAiRegistrations;
 
@@ -195,7 +195,19 @@ enum Flag2
   WEATHER_TOOLTIP_IVAO = 1 << 12,
 
   /* checkBoxOptionsMapZoomAvoidBlurred */
-  MAP_AVOID_BLURRED_MAP = 1 << 13
+  MAP_AVOID_BLURRED_MAP = 1 << 13,
+
+  /* Paint altitude grid and airspaces in background threads.
+   * ui->checkBoxOptionsMapParallelRendering */
+  MAP_PARALLEL_RENDERING = 1 << 14,
+
+  /* Show frame and painter times on map and write them to a log file.
+   * ui->checkBoxOptionsMapPaintStatistics */
+  MAP_PAINT_STATISTICS = 1 << 15,
+
+  /* Reduce map details automatically if painting exceeds the target frame time.
+   * ui->checkBoxOptionsMapAdaptiveDetail */
+  MAP_ADAPTIVE_DETAIL = 1 << 16
 
 };
 
@@ -564,6 +576,12 @@ public:
     return mapTooltipSensitivity;
   }
 
+  /* Target frame time in milliseconds for the adaptive map detail */
+  int getMapAdaptiveDetailFrameTime() const
+  {
+    return mapAdaptiveDetailFrameTime;
+  }
+
   /* Map symbol size in percent */
   int getMapSymbolSize() const
   {
@@ -928,6 +946,9 @@ private:
   // ui->spinBoxOptionsMapTooltipRect
   int mapTooltipSensitivity = 10;
 
+  // ui->spinBoxOptionsMapAdaptiveDetail
+  int mapAdaptiveDetailFrameTime = 50;
+
   // ui->spinBoxOptionsMapSymbolSize
   int mapSymbolSize = 100;
 
@@ -1010,7 +1031,7 @@ private:
   int displaySunShadingDimFactor = 40;
 
   // spinBoxSimMaxTrackPoints
-  int aircraftTrackMaxPoints = 20000;
+  int aircraftTrackMaxPoints = 100000;
 
   // spinBoxSimDoNotFollowOnScrollTime
   int simNoFollowAircraftOnScroll = 10;
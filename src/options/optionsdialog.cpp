@@ -298,6 +298,10 @@ OptionsDialog::OptionsDialog(QMainWindow *parentWindow)
 
   widgets.append(ui->checkBoxOptionsShowTod);
   widgets.append(ui->checkBoxOptionsMapZoomAvoidBlurred);
+  widgets.append(ui->checkBoxOptionsMapParallelRendering);
+  widgets.append(ui->checkBoxOptionsMapPaintStatistics);
+  widgets.append(ui->checkBoxOptionsMapAdaptiveDetail);
+  widgets.append(ui->spinBoxOptionsMapAdaptiveDetail);
 
   widgets.append(ui->checkBoxOptionsMapAirportText);
   widgets.append(ui->checkBoxOptionsMapNavaidText);
@@ -424,6 +428,9 @@ OptionsDialog::OptionsDialog(QMainWindow *parentWindow)
   connect(ui->checkBoxOptionsSimDoNotFollowOnScroll, &QCheckBox::toggled, this,
           &OptionsDialog::simNoFollowAircraftOnScrollClicked);
 
+  connect(ui->checkBoxOptionsMapAdaptiveDetail, &QCheckBox::toggled, this,
+          &OptionsDialog::mapAdaptiveDetailClicked);
+
   // Online tab =======================================================================
   connect(ui->radioButtonOptionsOnlineNone, &QRadioButton::clicked,
           this, &OptionsDialog::updateOnlineWidgetStatus);
@@ -705,6 +712,7 @@ void OptionsDialog::restoreState()
   simUpdatesConstantClicked(false);
   mapEmptyAirportsClicked(false);
   simNoFollowAircraftOnScrollClicked(false);
+  mapAdaptiveDetailClicked(false);
   updateButtonColors();
   onlineDisplayRangeClicked();
 }
@@ -984,6 +992,12 @@ void OptionsDialog::simNoFollowAircraftOnScrollClicked(bool state)
   ui->spinBoxSimDoNotFollowOnScrollTime->setEnabled(ui->checkBoxOptionsSimDoNotFollowOnScroll->isChecked());
 }
 
+void OptionsDialog::mapAdaptiveDetailClicked(bool state)
+{
+  Q_UNUSED(state);
+  ui->spinBoxOptionsMapAdaptiveDetail->setEnabled(ui->checkBoxOptionsMapAdaptiveDetail->isChecked());
+}
+
 /* Convert the range ring string to an int vector */
 QVector<int> OptionsDialog::ringStrToVector(const QString& string) const
 {
@@ -1050,6 +1064,9 @@ void OptionsDialog::widgetsToOptionData()
   toFlags(ui->checkBoxOptionsSimUpdatesConstant, opts::SIM_UPDATE_MAP_CONSTANTLY);
   toFlags(ui->checkBoxOptionsShowTod, opts::FLIGHT_PLAN_SHOW_TOD);
   toFlags2(ui->checkBoxOptionsMapZoomAvoidBlurred, opts::MAP_AVOID_BLURRED_MAP);
+  toFlags2(ui->checkBoxOptionsMapParallelRendering, opts::MAP_PARALLEL_RENDERING);
+  toFlags2(ui->checkBoxOptionsMapPaintStatistics, opts::MAP_PAINT_STATISTICS);
+  toFlags2(ui->checkBoxOptionsMapAdaptiveDetail, opts::MAP_ADAPTIVE_DETAIL);
 
   toFlags(ui->radioButtonCacheUseOffineElevation, opts::CACHE_USE_OFFLINE_ELEVATION);
   toFlags(ui->radioButtonCacheUseOnlineElevation, opts::CACHE_USE_ONLINE_ELEVATION);
@@ -1117,6 +1134,7 @@ void OptionsDialog::widgetsToOptionData()
 
   data.mapClickSensitivity = ui->spinBoxOptionsMapClickRect->value();
   data.mapTooltipSensitivity = ui->spinBoxOptionsMapTooltipRect->value();
+  data.mapAdaptiveDetailFrameTime = ui->spinBoxOptionsMapAdaptiveDetail->value();
 
   data.mapZoomShowClick = static_cast<float>(ui->doubleSpinBoxOptionsMapZoomShowMap->value());
   data.mapZoomShowMenu = static_cast<float>(ui->doubleSpinBoxOptionsMapZoomShowMapMenu->value());
@@ -1244,6 +1262,9 @@ void OptionsDialog::optionDataToWidgets()
   fromFlags(ui->checkBoxOptionsSimUpdatesConstant, opts::SIM_UPDATE_MAP_CONSTANTLY);
   fromFlags(ui->checkBoxOptionsShowTod, opts::FLIGHT_PLAN_SHOW_TOD);
   fromFlags2(ui->checkBoxOptionsMapZoomAvoidBlurred, opts::MAP_AVOID_BLURRED_MAP);
+  fromFlags2(ui->checkBoxOptionsMapParallelRendering, opts::MAP_PARALLEL_RENDERING);
+  fromFlags2(ui->checkBoxOptionsMapPaintStatistics, opts::MAP_PAINT_STATISTICS);
+  fromFlags2(ui->checkBoxOptionsMapAdaptiveDetail, opts::MAP_ADAPTIVE_DETAIL);
 
   fromFlags(ui->radioButtonCacheUseOffineElevation, opts::CACHE_USE_OFFLINE_ELEVATION);
   fromFlags(ui->radioButtonCacheUseOnlineElevation, opts::CACHE_USE_ONLINE_ELEVATION);
@@ -1326,6 +1347,7 @@ void OptionsDialog::optionDataToWidgets()
 
   ui->spinBoxOptionsMapClickRect->setValue(data.mapClickSensitivity);
   ui->spinBoxOptionsMapTooltipRect->setValue(data.mapTooltipSensitivity);
+  ui->spinBoxOptionsMapAdaptiveDetail->setValue(data.mapAdaptiveDetailFrameTime);
   ui->doubleSpinBoxOptionsMapZoomShowMap->setValue(data.mapZoomShowClick);
   ui->doubleSpinBoxOptionsMapZoomShowMapMenu->setValue(data.mapZoomShowMenu);
   ui->spinBoxOptionsRouteGroundBuffer->setValue(data.routeGroundBuffer);
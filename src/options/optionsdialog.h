@@ -92,6 +92,7 @@ private:
   void addDatabaseAddOnExcludePathClicked();
   void removeDatabaseAddOnExcludePathClicked();
   void simNoFollowAircraftOnScrollClicked(bool state);
+  void mapAdaptiveDetailClicked(bool state);
 
   void showDiskCacheClicked();
   void updateDatabaseButtonState();
@@ -802,12 +802,12 @@ bool AircraftPerfController::useFuelAsVolume() const
   return perf->useFuelAsVolume();
 }
 
-void AircraftPerfController::simDataChanged(const atools::fs::sc::SimConnectData& simulatorData)
+void AircraftPerfController::simDataChanged(const SimConnectDataPtr& simulatorData)
 {
   if(perfHandler != nullptr)
   {
     // Pass to handler for averaging
-    perfHandler->simDataChanged(simulatorData);
+    perfHandler->simDataChanged(*simulatorData);
 
     qint64 currentSampleTime = QDateTime::currentMSecsSinceEpoch();
     if(currentSampleTime > reportLastSampleTimeMs + 1000)
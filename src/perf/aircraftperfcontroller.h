@@ -18,6 +18,7 @@
 #ifndef LNM_AIRCRAFTPERFCONTROLLER_H
 #define LNM_AIRCRAFTPERFCONTROLLER_H
 
+#include "connect/simdatasnapshot.h"
 #include "fs/perf/aircraftperfconstants.h"
 
 #include <QTimer>
@@ -119,7 +120,7 @@ public:
   bool useFuelAsVolume() const;
 
   /* Updates for automatic performance calculation */
-  void simDataChanged(const atools::fs::sc::SimConnectData& simulatorData);
+  void simDataChanged(const SimConnectDataPtr& simulatorData);
 
   /* Cruise speed knots TAS */
   float getRouteCruiseSpeedKts();
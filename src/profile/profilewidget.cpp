@@ -128,9 +128,9 @@ void ProfileWidget::aircraftTrackPruned()
   update();
 }
 
-void ProfileWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorData)
+void ProfileWidget::simDataChanged(const SimConnectDataPtr& simulatorData)
 {
-  if(!widgetVisible || databaseLoadStatus || !simulatorData.getUserAircraftConst().getPosition().isValid())
+  if(!widgetVisible || databaseLoadStatus || !simulatorData->getUserAircraftConst().getPosition().isValid())
     return;
 
   bool updateWidget = false;
@@ -146,14 +146,14 @@ void ProfileWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulat
       // {
       simData = simulatorData;
 
-      Pos lastPos = lastSimData.getUserAircraftConst().getPosition();
-      Pos simPos = simData.getUserAircraftConst().getPosition();
+      Pos lastPos = lastSimData->getUserAircraftConst().getPosition();
+      Pos simPos = simData->getUserAircraftConst().getPosition();
 
       aircraftDistanceFromStart = route.getProjectionDistance();
       if(aircraftDistanceFromStart < map::INVALID_DISTANCE_VALUE)
       {
 #ifdef DEBUG_INFORMATION_PROFILE_SIMDATA
-        if(simData.getUserAircraft().isDebug())
+        if(simData->getUserAircraftConst().isDebug())
           qDebug() << Q_FUNC_INFO << aircraftDistanceFromStart;
 #endif
 
@@ -209,8 +209,8 @@ void ProfileWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulat
     else
     {
       // Neither aircraft nor track shown - update simulator data only
-      bool valid = simData.getUserAircraftConst().getPosition().isValid();
-      simData = atools::fs::sc::SimConnectData();
+      bool valid = simData->getUserAircraftConst().getPosition().isValid();
+      simData = simdata::emptySnapshot();
       if(valid)
         updateWidget = true;
     }
@@ -226,7 +226,7 @@ void ProfileWidget::connectedToSimulator()
 {
   qDebug() << Q_FUNC_INFO;
   jumpBack->cancel();
-  simData = atools::fs::sc::SimConnectData();
+  simData = simdata::emptySnapshot();
   updateScreenCoords();
   update();
   updateLabel();
@@ -236,7 +236,7 @@ void ProfileWidget::disconnectedFromSimulator()
 {
   qDebug() << Q_FUNC_INFO;
   jumpBack->cancel();
-  simData = atools::fs::sc::SimConnectData();
+  simData = simdata::emptySnapshot();
   updateScreenCoords();
   update();
   updateLabel();
@@ -267,9 +267,9 @@ void ProfileWidget::updateScreenCoords()
   flightplanAltFt = routeController->getRoute().getCruisingAltitudeFeet();
   maxWindowAlt = std::max(minSafeAltitudeFt, flightplanAltFt);
 
-  if(simData.getUserAircraftConst().getPosition().isValid() &&
+  if(simData->getUserAircraftConst().getPosition().isValid() &&
      (showAircraft || showAircraftTrack) && !NavApp::getRouteConst().isFlightplanEmpty())
-    maxWindowAlt = std::max(maxWindowAlt, simData.getUserAircraftConst().getPosition().getAltitude());
+    maxWindowAlt = std::max(maxWindowAlt, simData->getUserAircraftConst().getPosition().getAltitude());
 
   // if(showAircraftTrack)
   // maxWindowAlt = std::max(maxWindowAlt, maxTrackAltitudeFt);
@@ -1099,12 +1099,12 @@ void ProfileWidget::paintEvent(QPaintEvent *)
   }
 
   // Draw user aircraft =========================================================
-  if( /*!route.isPassedLastLeg() && !route.isActiveMissed() &&*/ simData.getUserAircraftConst().getPosition().isValid()
+  if( /*!route.isPassedLastLeg() && !route.isActiveMissed() &&*/ simData->getUserAircraftConst().getPosition().isValid()
                                                                  &&
                                                                  showAircraft)
   {
     float acx = distanceX(aircraftDistanceFromStart);
-    float acy = altitudeY(simData.getUserAircraftConst().getPosition().getAltitude());
+    float acy = altitudeY(simData->getUserAircraftConst().getPosition().getAltitude());
 
     // Draw aircraft symbol
     int acsize = atools::roundToInt(optData.getDisplaySymbolSizeAircraftUser() / 100. * 32.);
@@ -1113,13 +1113,13 @@ void ProfileWidget::paintEvent(QPaintEvent *)
     painter.scale(0.75, 1.);
     painter.shear(0.0, 0.5);
     painter.drawPixmap(QPointF(-acsize / 2., -acsize / 2.),
-                       *NavApp::getVehicleIcons()->pixmapFromCache(simData.getUserAircraftConst(), acsize, 0));
+                       *NavApp::getVehicleIcons()->pixmapFromCache(simData->getUserAircraftConst(), acsize, 0));
     painter.resetTransform();
 
     // Draw aircraft label
     mapcolors::scaleFont(&painter, optData.getDisplayTextSizeAircraftUser() / 100.f, &defaultFont);
 
-    int vspeed = atools::roundToInt(simData.getUserAircraftConst().getVerticalSpeedFeetPerMin());
+    int vspeed = atools::roundToInt(simData->getUserAircraftConst().getVerticalSpeedFeetPerMin());
     QString upDown;
     if(vspeed > 100.f)
       upDown = tr(" ▲");
@@ -1127,7 +1127,7 @@ void ProfileWidget::paintEvent(QPaintEvent *)
       upDown = tr(" ▼");
 
     QStringList texts;
-    texts.append(Unit::altFeet(simData.getUserAircraftConst().getPosition().getAltitude()));
+    texts.append(Unit::altFeet(simData->getUserAircraftConst().getPosition().getAltitude()));
 
     if(vspeed > 10.f || vspeed < -10.f)
       texts.append(Unit::speedVertFpm(vspeed) + upDown);
@@ -1618,7 +1618,7 @@ void ProfileWidget::updateLabel()
 {
   float distFromStartNm = 0.f, distToDestNm = 0.f;
 
-  if(simData.getUserAircraftConst().getPosition().isValid())
+  if(simData->getUserAircraftConst().getPosition().isValid())
   {
     if(routeController->getRoute().getRouteDistances(&distFromStartNm, &distToDestNm))
     {
@@ -1790,10 +1790,10 @@ void ProfileWidget::jumpBackToAircraftTimeout()
     else
     {
       jumpBack->cancel();
-      if(simData.getUserAircraft().getPosition().isValid())
+      if(simData->getUserAircraftConst().getPosition().isValid())
       {
         scrollArea->centerAircraft(toScreen(QPointF(aircraftDistanceFromStart,
-                                                    simData.getUserAircraft().getPosition().getAltitude())));
+                                                    simData->getUserAircraftConst().getPosition().getAltitude())));
 
         NavApp::setStatusMessage(tr("Jumped back to aircraft."));
       }
@@ -18,6 +18,7 @@
 #ifndef LITTLENAVMAP_PROFILEWIDGET_H
 #define LITTLENAVMAP_PROFILEWIDGET_H
 
+#include "connect/simdatasnapshot.h"
 #include "route/route.h"
 #include "fs/sc/simconnectdata.h"
 
@@ -63,7 +64,7 @@ public:
   void routeAltitudeChanged(int altitudeFeet);
 
   /* Update user aircraft on profile display */
-  void simDataChanged(const atools::fs::sc::SimConnectData& simulatorData);
+  void simDataChanged(const SimConnectDataPtr& simulatorData);
 
   /* Track was shortened and needs a full update */
   void aircraftTrackPruned();
@@ -237,8 +238,8 @@ private:
   /* Do not calculate a profile for legs longer than this value */
   static Q_DECL_CONSTEXPR int ELEVATION_MAX_LEG_NM = 2000;
 
-  /* User aircraft data */
-  atools::fs::sc::SimConnectData simData, lastSimData;
+  /* User aircraft data. Shared snapshots which are never null. */
+  SimConnectDataPtr simData = simdata::emptySnapshot(), lastSimData = simdata::emptySnapshot();
   QPolygon aircraftTrackPoints;
 
   float aircraftDistanceFromStart;
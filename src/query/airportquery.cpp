@@ -27,8 +27,10 @@
 #include "settings/settings.h"
 #include "fs/common/xpgeometry.h"
 #include "navapp.h"
+#include "common/paintstatistics.h"
 
 #include <QDataStream>
+#include <QElapsedTimer>
 #include <QRegularExpression>
 
 using namespace Marble;
@@ -130,14 +132,32 @@ void AirportQuery::getAirportByIdent(map::MapAirport& airport, const QString& id
 
 Pos AirportQuery::getAirportCoordinatesByIdent(const QString& ident)
 {
-  Pos pos;
-  airportCoordsByIdentQuery->bindValue(":ident", ident);
+  if(!airportCoordsLoaded)
+    loadAirportCoordinates();
+
+  return airportCoordsByIdent.value(ident);
+}
+
+void AirportQuery::loadAirportCoordinates()
+{
+  // Weather readers look up the coordinates of all stations to build their nearest index.
+  // Load all in one query instead of querying each station.
+  QElapsedTimer timer;
+  timer.start();
+
   airportCoordsByIdentQuery->exec();
-  if(airportCoordsByIdentQuery->next())
-    pos = Pos(airportCoordsByIdentQuery->value("lonx").toFloat(),
-              airportCoordsByIdentQuery->value("laty").toFloat());
+  while(airportCoordsByIdentQuery->next())
+  {
+    QString ident = airportCoordsByIdentQuery->valueStr("ident");
+    if(!airportCoordsByIdent.contains(ident))
+      airportCoordsByIdent.insert(ident, Pos(airportCoordsByIdentQuery->value("lonx").toFloat(),
+                                             airportCoordsByIdentQuery->value("laty").toFloat()));
+  }
   airportCoordsByIdentQuery->finish();
-  return pos;
+  airportCoordsLoaded = true;
+
+  qDebug() << Q_FUNC_INFO << "Loaded" << airportCoordsByIdent.size() << "airport coordinates in"
+           << timer.elapsed() << "ms";
 }
 
 bool AirportQuery::hasProcedures(const QString& ident) const
@@ -222,6 +242,8 @@ const QList<map::MapApron> *AirportQuery::getAprons(int airportId)
     return apronCache.object(airportId);
   else
   {
+    pstats::ScopedTimer timer("Aprons");
+
     apronQuery->bindValue(":airportId", airportId);
     apronQuery->exec();
 
@@ -261,6 +283,8 @@ const QList<map::MapParking> *AirportQuery::getParkingsForAirport(int airportId)
     return parkingCache.object(airportId);
   else
   {
+    pstats::ScopedTimer timer("Parking");
+
     parkingQuery->bindValue(":airportId", airportId);
     parkingQuery->exec();
 
@@ -284,6 +308,8 @@ const QList<map::MapStart> *AirportQuery::getStartPositionsForAirport(int airpor
     return startCache.object(airportId);
   else
   {
+    pstats::ScopedTimer timer("Starts");
+
     startQuery->bindValue(":airportId", airportId);
     startQuery->exec();
 
@@ -467,6 +493,8 @@ const QList<map::MapHelipad> *AirportQuery::getHelipads(int airportId)
     return helipadCache.object(airportId);
   else
   {
+    pstats::ScopedTimer timer("Helipads");
+
     helipadQuery->bindValue(":airportId", airportId);
     helipadQuery->exec();
 
@@ -573,6 +601,8 @@ const QList<map::MapTaxiPath> *AirportQuery::getTaxiPaths(int airportId)
     return taxipathCache.object(airportId);
   else
   {
+    pstats::ScopedTimer timer("Taxipaths");
+
     taxiparthQuery->bindValue(":airportId", airportId);
     taxiparthQuery->exec();
 
@@ -602,6 +632,8 @@ const QList<map::MapRunway> *AirportQuery::getRunways(int airportId)
     return runwayCache.object(airportId);
   else
   {
+    pstats::ScopedTimer timer("Runways");
+
     runwaysQuery->bindValue(":airportId", airportId);
     runwaysQuery->exec();
 
@@ -780,7 +812,7 @@ void AirportQuery::initQueries()
   airportByIdentQuery->prepare("select " + airportQueryBase.join(", ") + " from airport where ident = :ident ");
 
   airportCoordsByIdentQuery = new SqlQuery(db);
-  airportCoordsByIdentQuery->prepare("select lonx, laty from airport where ident = :ident ");
+  airportCoordsByIdentQuery->prepare("select ident, lonx, laty from airport");
 
   runwayEndByIdQuery = new SqlQuery(db);
   runwayEndByIdQuery->prepare("select runway_end_id, end_type, name, heading, left_vasi_pitch, right_vasi_pitch, "
@@ -872,6 +904,8 @@ void AirportQuery::deInitQueries()
   helipadCache.clear();
   airportIdentCache.clear();
   airportIdCache.clear();
+  airportCoordsByIdent.clear();
+  airportCoordsLoaded = false;
 
   delete runwayOverviewQuery;
   runwayOverviewQuery = nullptr;
@@ -67,6 +67,7 @@ public:
   map::MapAirport getAirportById(int airportId);
 
   void getAirportByIdent(map::MapAirport& airport, const QString& ident);
+  /* Coordinates from an index of all airports which is loaded on first call. Invalid if not found. */
   atools::geo::Pos getAirportCoordinatesByIdent(const QString& ident);
 
   bool hasProcedures(const QString& ident) const;
@@ -155,6 +156,7 @@ private:
 
   bool runwayCompare(const map::MapRunway& r1, const map::MapRunway& r2);
   bool hasQueryByAirportIdent(atools::sql::SqlQuery& query, const QString& ident) const;
+  void loadAirportCoordinates();
 
   const int queryRowLimit = 5000;
 
@@ -175,6 +177,10 @@ private:
   QCache<QString, map::MapAirport> airportIdentCache;
   QCache<int, map::MapAirport> airportIdCache;
 
+  /* Coordinates of all airports by ident used by the weather nearest station index */
+  QHash<QString, atools::geo::Pos> airportCoordsByIdent;
+  bool airportCoordsLoaded = false;
+
   /* Database queries */
   atools::sql::SqlQuery *runwayOverviewQuery = nullptr, *apronQuery = nullptr,
                         *parkingQuery = nullptr, *startQuery = nullptr, *startByIdQuery = nullptr,
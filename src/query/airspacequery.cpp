@@ -28,6 +28,7 @@
 #include "settings/settings.h"
 #include "fs/common/xpgeometry.h"
 #include "db/databasemanager.h"
+#include "common/paintstatistics.h"
 
 #include <QDataStream>
 #include <QRegularExpression>
@@ -125,6 +126,8 @@ const QList<map::MapAirspace> *AirspaceQuery::getAirspaces(const GeoDataLatLonBo
 
   if(airspaceCache.list.isEmpty() && !lazy)
   {
+    pstats::ScopedTimer timer("Airspaces");
+
     QStringList typeStrings;
 
     if(filter.types != map::AIRSPACE_NONE)
@@ -235,6 +238,8 @@ const LineString *AirspaceQuery::getAirspaceGeometry(int boundaryId)
     return airspaceLineCache.object(boundaryId);
   else
   {
+    pstats::ScopedTimer timer("Airspace geometry");
+
     LineString *lines = new LineString;
 
     airspaceLinesByIdQuery->bindValue(":id", boundaryId);
@@ -0,0 +1,130 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "query/identindex.h"
+
+#include "sql/sqlquery.h"
+
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include <algorithm>
+
+using atools::sql::SqlQuery;
+using atools::sql::SqlDatabase;
+
+void IdentIndex::load(SqlDatabase *dbSim, SqlDatabase *dbNav)
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  clear();
+  loadIdents(airportIdents, dbSim, "select ident from airport");
+  loadIdents(vorIdents, dbNav, "select ident from vor");
+  loadIdents(ndbIdents, dbNav, "select ident from ndb");
+  loadIdents(waypointIdents, dbNav, "select ident from waypoint");
+  loadIdents(airwayNames, dbNav, "select distinct airway_name from airway");
+  loaded = true;
+
+  qDebug() << Q_FUNC_INFO << "Loaded" << airportIdents.size() << "airports" << vorIdents.size() << "VOR"
+           << ndbIdents.size() << "NDB" << waypointIdents.size() << "waypoints" << airwayNames.size()
+           << "airways in" << timer.elapsed() << "ms";
+}
+
+void IdentIndex::clear()
+{
+  airportIdents.clear();
+  vorIdents.clear();
+  ndbIdents.clear();
+  waypointIdents.clear();
+  airwayNames.clear();
+  loaded = false;
+}
+
+void IdentIndex::loadIdents(QVector<QString>& idents, SqlDatabase *db, const QString& queryStr)
+{
+  SqlQuery query(db);
+  query.exec(queryStr);
+  while(query.next())
+    idents.append(query.value(0).toString());
+
+  // Sort here instead of in SQL to get the same order as the QString comparison operators
+  std::sort(idents.begin(), idents.end());
+  idents.erase(std::unique(idents.begin(), idents.end()), idents.end());
+  idents.squeeze();
+}
+
+bool IdentIndex::contains(const QString& ident, map::MapObjectTypes types) const
+{
+  if(!loaded)
+    return true;
+
+  if(types & ~(map::AIRPORT | map::VOR | map::NDB | map::WAYPOINT | map::AIRWAY))
+    // Not indexed type included
+    return true;
+
+  if((types & map::AIRPORT) && std::binary_search(airportIdents.begin(), airportIdents.end(), ident))
+    return true;
+
+  if((types & map::VOR) && std::binary_search(vorIdents.begin(), vorIdents.end(), ident))
+    return true;
+
+  if((types & map::NDB) && std::binary_search(ndbIdents.begin(), ndbIdents.end(), ident))
+    return true;
+
+  if((types & map::WAYPOINT) && std::binary_search(waypointIdents.begin(), waypointIdents.end(), ident))
+    return true;
+
+  if((types & map::AIRWAY) && std::binary_search(airwayNames.begin(), airwayNames.end(), ident))
+    return true;
+
+  return false;
+}
+
+/* Append up to maxNumber idents starting with prefix */
+static void collectIdents(QStringList& result, const QVector<QString>& idents, const QString& prefix, int maxNumber)
+{
+  int num = 0;
+  for(auto it = std::lower_bound(idents.begin(), idents.end(), prefix);
+      it != idents.end() && it->startsWith(prefix) && num < maxNumber; ++it, num++)
+    result.append(*it);
+}
+
+QStringList IdentIndex::getIdentsByPrefix(const QString& prefix, map::MapObjectTypes types, int maxNumber) const
+{
+  QStringList result;
+  if(prefix.isEmpty())
+    return result;
+
+  if(types & map::AIRPORT)
+    collectIdents(result, airportIdents, prefix, maxNumber);
+  if(types & map::VOR)
+    collectIdents(result, vorIdents, prefix, maxNumber);
+  if(types & map::NDB)
+    collectIdents(result, ndbIdents, prefix, maxNumber);
+  if(types & map::WAYPOINT)
+    collectIdents(result, waypointIdents, prefix, maxNumber);
+  if(types & map::AIRWAY)
+    collectIdents(result, airwayNames, prefix, maxNumber);
+
+  // Merge results from all lists and cut off
+  result.sort();
+  result.removeDuplicates();
+  if(result.size() > maxNumber)
+    result.erase(result.begin() + maxNumber, result.end());
+  return result;
+}
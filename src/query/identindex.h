@@ -0,0 +1,61 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_IDENTINDEX_H
+#define LITTLENAVMAP_IDENTINDEX_H
+
+#include "common/mapflags.h"
+
+#include <QStringList>
+#include <QVector>
+
+namespace atools {
+namespace sql {
+class SqlDatabase;
+}
+}
+
+/*
+ * Sorted lists of all airport, VOR, NDB and waypoint idents and airway names.
+ * Allows fast prefix lookups for completion and to skip database queries for idents that do not exist.
+ */
+class IdentIndex
+{
+public:
+  /* Load all idents. Airports are read from the simulator database and all others from the navaid database. */
+  void load(atools::sql::SqlDatabase *dbSim, atools::sql::SqlDatabase *dbNav);
+  void clear();
+
+  bool isLoaded() const
+  {
+    return loaded;
+  }
+
+  /* True if the ident exists for at least one of the given types. Always true for types which are not indexed. */
+  bool contains(const QString& ident, map::MapObjectTypes types) const;
+
+  /* Get sorted and unique idents of the given types starting with prefix. Case sensitive. */
+  QStringList getIdentsByPrefix(const QString& prefix, map::MapObjectTypes types, int maxNumber) const;
+
+private:
+  void loadIdents(QVector<QString>& idents, atools::sql::SqlDatabase *db, const QString& queryStr);
+
+  QVector<QString> airportIdents, vorIdents, ndbIdents, waypointIdents, airwayNames;
+  bool loaded = false;
+};
+
+#endif // LITTLENAVMAP_IDENTINDEX_H
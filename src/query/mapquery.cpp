@@ -30,6 +30,7 @@
 #include "settings/settings.h"
 #include "fs/common/xpgeometry.h"
 #include "db/databasemanager.h"
+#include "common/paintstatistics.h"
 
 #include <QDataStream>
 #include <QRegularExpression>
@@ -268,11 +269,27 @@ void MapQuery::getMapObjectByIdent(map::MapSearchResult& result, map::MapObjectT
                            airportFromNavDatabase);
 }
 
+QStringList MapQuery::getIdentsByPrefix(const QString& prefix, map::MapObjectTypes types, int maxNumber)
+{
+  return getIdentIndex().getIdentsByPrefix(prefix, types, maxNumber);
+}
+
+const IdentIndex& MapQuery::getIdentIndex()
+{
+  if(!identIndex.isLoaded())
+    identIndex.load(dbSim, dbNav);
+  return identIndex;
+}
+
 void MapQuery::mapObjectByIdentInternal(map::MapSearchResult& result, map::MapObjectTypes type, const QString& ident,
                                         const QString& region, const QString& airport, const Pos& sortByDistancePos,
                                         float maxDistance, bool airportFromNavDatabase)
 {
-  if(type & map::AIRPORT)
+  // Skip queries for idents which do not exist at all - route string parsing tries all types for each word
+  const IdentIndex& index = getIdentIndex();
+
+  // Index contains only simulator airports
+  if((type & map::AIRPORT) && (airportFromNavDatabase || index.contains(ident, map::AIRPORT)))
   {
     map::MapAirport ap;
 
@@ -289,7 +306,7 @@ void MapQuery::mapObjectByIdentInternal(map::MapSearchResult& result, map::MapOb
     }
   }
 
-  if(type & map::VOR)
+  if((type & map::VOR) && index.contains(ident, map::VOR))
   {
     vorByIdentQuery->bindValue(":ident", ident);
     vorByIdentQuery->bindValue(":region", region.isEmpty() ? "%" : region);
@@ -304,7 +321,7 @@ void MapQuery::mapObjectByIdentInternal(map::MapSearchResult& result, map::MapOb
     maptools::removeByDistance(result.vors, sortByDistancePos, maxDistance);
   }
 
-  if(type & map::NDB)
+  if((type & map::NDB) && index.contains(ident, map::NDB))
   {
     ndbByIdentQuery->bindValue(":ident", ident);
     ndbByIdentQuery->bindValue(":region", region.isEmpty() ? "%" : region);
@@ -319,7 +336,7 @@ void MapQuery::mapObjectByIdentInternal(map::MapSearchResult& result, map::MapOb
     maptools::removeByDistance(result.ndbs, sortByDistancePos, maxDistance);
   }
 
-  if(type & map::WAYPOINT)
+  if((type & map::WAYPOINT) && index.contains(ident, map::WAYPOINT))
   {
     waypointByIdentQuery->bindValue(":ident", ident);
     waypointByIdentQuery->bindValue(":region", region.isEmpty() ? "%" : region);
@@ -357,7 +374,7 @@ void MapQuery::mapObjectByIdentInternal(map::MapSearchResult& result, map::MapOb
       NavApp::getAirportQuerySim()->getRunwayEndByNames(result, ident, airport);
   }
 
-  if(type & map::AIRWAY)
+  if((type & map::AIRWAY) && index.contains(ident, map::AIRWAY))
   {
     airwayByNameQuery->bindValue(":name", ident);
     airwayByNameQuery->exec();
@@ -703,6 +720,8 @@ const QList<map::MapWaypoint> *MapQuery::getWaypoints(const GeoDataLatLonBox& re
 
   if(waypointCache.list.isEmpty() && !lazy)
   {
+    pstats::ScopedTimer timer("Waypoints");
+
     for(const GeoDataLatLonBox& r :
         query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
     {
@@ -731,6 +750,8 @@ const QList<map::MapVor> *MapQuery::getVors(const GeoDataLatLonBox& rect, const
 
   if(vorCache.list.isEmpty() && !lazy)
   {
+    pstats::ScopedTimer timer("VOR");
+
     for(const GeoDataLatLonBox& r :
         query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
     {
@@ -759,6 +780,8 @@ const QList<map::MapNdb> *MapQuery::getNdbs(const GeoDataLatLonBox& rect, const
 
   if(ndbCache.list.isEmpty() && !lazy)
   {
+    pstats::ScopedTimer timer("NDB");
+
     for(const GeoDataLatLonBox& r :
         query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
     {
@@ -842,6 +865,8 @@ const QList<map::MapMarker> *MapQuery::getMarkers(const GeoDataLatLonBox& rect,
 
   if(markerCache.list.isEmpty() && !lazy)
   {
+    pstats::ScopedTimer timer("Markers");
+
     for(const GeoDataLatLonBox& r :
         query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
     {
@@ -869,6 +894,8 @@ const QList<map::MapIls> *MapQuery::getIls(GeoDataLatLonBox rect, const MapLayer
 
   if(ilsCache.list.isEmpty() && !lazy)
   {
+    pstats::ScopedTimer timer("ILS");
+
     // ILS length is 9 NM * 1' per degree
     double increase = atools::geo::toRadians(9. / 60.);
 
@@ -904,6 +931,8 @@ const QList<map::MapAirway> *MapQuery::getAirways(const GeoDataLatLonBox& rect,
 
   if(airwayCache.list.isEmpty() && !lazy)
   {
+    pstats::ScopedTimer timer("Airways");
+
     QSet<int> ids;
     for(const GeoDataLatLonBox& r :
         query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
@@ -947,6 +976,8 @@ const QList<map::MapAirport> *MapQuery::fetchAirports(const Marble::GeoDataLatLo
 {
   if(airportCache.list.isEmpty() && !lazy)
   {
+    pstats::ScopedTimer timer("Airports");
+
     bool navdata = NavApp::getDatabaseManager()->getNavDatabaseStatus() == dm::NAVDATABASE_ALL;
     for(const GeoDataLatLonBox& r :
         query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
@@ -978,6 +1009,8 @@ const QList<map::MapRunway> *MapQuery::getRunwaysForOverview(int airportId)
     return runwayOverwiewCache.object(airportId);
   else
   {
+    pstats::ScopedTimer timer("Runway overview");
+
     using atools::geo::Pos;
 
     runwayOverviewQuery->bindValue(":airportId", airportId);
@@ -1207,6 +1240,7 @@ void MapQuery::initQueries()
 
 void MapQuery::deInitQueries()
 {
+  identIndex.clear();
   airportCache.clear();
   waypointCache.clear();
   vorCache.clear();
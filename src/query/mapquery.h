@@ -19,6 +19,7 @@
 #define LITTLENAVMAP_MAPQUERY_H
 
 #include "query/querytypes.h"
+#include "query/identindex.h"
 #include "common/maptypes.h"
 
 #include <QCache>
@@ -118,6 +119,10 @@ public:
                            const QString& ident, const QString& region,
                            const QString& airport, bool airportFromNavDatabase);
 
+  /* Get sorted idents of airports, navaids and airways starting with prefix for completion.
+   * Uses an in memory index which is loaded on first use. */
+  QStringList getIdentsByPrefix(const QString& prefix, map::MapObjectTypes types, int maxNumber);
+
   /*
    * Get a map object by type and id
    * @param result will receive objects based on type
@@ -197,6 +202,9 @@ private:
 
   bool runwayCompare(const map::MapRunway& r1, const map::MapRunway& r2);
 
+  /* Load ident index if needed */
+  const IdentIndex& getIdentIndex();
+
   MapTypesFactory *mapTypesFactory;
   atools::sql::SqlDatabase *dbSim, *dbNav, *dbUser;
 
@@ -210,6 +218,9 @@ private:
   SimpleRectCache<map::MapIls> ilsCache;
   SimpleRectCache<map::MapAirway> airwayCache;
 
+  /* All idents used to avoid queries for not existing objects and for completion */
+  IdentIndex identIndex;
+
   /* ID/object caches */
   QCache<int, QList<map::MapRunway> > runwayOverwiewCache;
 
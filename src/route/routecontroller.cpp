@@ -3240,36 +3240,31 @@ void RouteController::disconnectedFromSimulator()
   emit routeChanged(false);
 }
 
-void RouteController::simDataChanged(const atools::fs::sc::SimConnectData& simulatorData)
+void RouteController::simDataChanged(const SimConnectDataPtr& simulatorData)
 {
-  if(atools::almostNotEqual(QDateTime::currentDateTime().toMSecsSinceEpoch(),
-                            lastSimUpdate, static_cast<qint64>(MIN_SIM_UPDATE_TIME_MS)))
+  if(simulatorData->isUserAircraftValid())
   {
-    if(simulatorData.isUserAircraftValid())
+    const atools::fs::sc::SimConnectUserAircraft& aircraft = simulatorData->getUserAircraftConst();
+
+    // Sequence only for airborne airplanes
+    // Use more than one parameter since first X-Plane data packets are unreliable
+    if(aircraft.isFlying())
     {
-      const atools::fs::sc::SimConnectUserAircraft& aircraft = simulatorData.getUserAircraftConst();
+      map::PosCourse position(aircraft.getPosition(), aircraft.getTrackDegTrue());
+      int previousRouteLeg = route.getActiveLegIndexCorrected();
+      route.updateActiveLegAndPos(position);
+      int routeLeg = route.getActiveLegIndexCorrected();
 
-      // Sequence only for airborne airplanes
-      // Use more than one parameter since first X-Plane data packets are unreliable
-      if(aircraft.isFlying())
+      if(routeLeg != previousRouteLeg)
       {
-        map::PosCourse position(aircraft.getPosition(), aircraft.getTrackDegTrue());
-        int previousRouteLeg = route.getActiveLegIndexCorrected();
-        route.updateActiveLegAndPos(position);
-        int routeLeg = route.getActiveLegIndexCorrected();
-
-        if(routeLeg != previousRouteLeg)
-        {
-          // Use corrected indexes to highlight initial fix
-          qDebug() << "new route leg" << previousRouteLeg << routeLeg;
-          highlightNextWaypoint(routeLeg);
+        // Use corrected indexes to highlight initial fix
+        qDebug() << "new route leg" << previousRouteLeg << routeLeg;
+        highlightNextWaypoint(routeLeg);
 
-          if(OptionData::instance().getFlags2() & opts::ROUTE_CENTER_ACTIVE_LEG)
-            view->scrollTo(model->index(std::max(routeLeg - 1, 0), 0), QAbstractItemView::PositionAtTop);
-        }
+        if(OptionData::instance().getFlags2() & opts::ROUTE_CENTER_ACTIVE_LEG)
+          view->scrollTo(model->index(std::max(routeLeg - 1, 0), 0), QAbstractItemView::PositionAtTop);
       }
     }
-    lastSimUpdate = QDateTime::currentDateTime().toMSecsSinceEpoch();
   }
 }
 
@@ -18,6 +18,7 @@
 #ifndef LITTLENAVMAP_ROUTECONTROLLER_H
 #define LITTLENAVMAP_ROUTECONTROLLER_H
 
+#include "connect/simdatasnapshot.h"
 #include "route/routecommand.h"
 #include "route/route.h"
 
@@ -73,6 +74,9 @@ public:
   RouteController(QMainWindow *parent, QTableView *tableView);
   virtual ~RouteController();
 
+  /* Do not update aircraft information more than every 0.1 seconds. Used by the sim data dispatcher. */
+  static Q_DECL_CONSTEXPR int MIN_SIM_UPDATE_TIME_MS = 100;
+
   /* Creates a new plan and emits routeChanged */
   void newFlightplan();
 
@@ -221,7 +225,8 @@ public:
 
   void disconnectedFromSimulator();
 
-  void simDataChanged(const atools::fs::sc::SimConnectData& simulatorData);
+  /* Update active leg. Called at most every MIN_SIM_UPDATE_TIME_MS. */
+  void simDataChanged(const SimConnectDataPtr& simulatorData);
 
   void editUserWaypointName(int index);
 
@@ -420,10 +425,7 @@ private:
   FlightplanEntryBuilder *entryBuilder = nullptr;
   atools::fs::pln::FlightplanIO *flightplanIO = nullptr;
 
-  /* Do not update aircraft information more than every 0.1 seconds */
-  static Q_DECL_CONSTEXPR int MIN_SIM_UPDATE_TIME_MS = 100;
   static Q_DECL_CONSTEXPR int ROUTE_ALT_CHANGE_DELAY_MS = 500;
-  qint64 lastSimUpdate = 0;
 
   QIcon ndbIcon, waypointIcon, userpointIcon, invalidIcon, procedureIcon;
   SymbolPainter *symbolPainter = nullptr;
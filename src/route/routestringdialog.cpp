@@ -26,13 +26,23 @@
 #include "gui/widgetstate.h"
 #include "common/constants.h"
 #include "common/unit.h"
+#include "query/mapquery.h"
 
 #include "ui_routestringdialog.h"
 
+#include <QAbstractItemView>
 #include <QClipboard>
+#include <QCompleter>
+#include <QKeyEvent>
+#include <QRegularExpression>
+#include <QScrollBar>
+#include <QStringListModel>
 
 using atools::gui::HelpHandler;
 
+/* Maximum number of idents shown in the completer popup */
+const static int MAX_COMPLETER_IDENTS = 50;
+
 RouteStringDialog::RouteStringDialog(QWidget *parent, RouteController *routeController)
   : QDialog(parent), ui(new Ui::RouteStringDialog), controller(routeController)
 {
@@ -112,6 +122,20 @@ RouteStringDialog::RouteStringDialog(QWidget *parent, RouteController *routeCont
           &RouteStringDialog::toolButtonOptionTriggered);
 
   connect(ui->pushButtonRouteStringUpdate, &QPushButton::clicked, this, &RouteStringDialog::updateButtonClicked);
+
+  // Complete airport and navaid idents and airway names while typing
+  identCompleterModel = new QStringListModel(this);
+  identCompleter = new QCompleter(identCompleterModel, this);
+  identCompleter->setWidget(ui->plainTextEditRouteString);
+  identCompleter->setCaseSensitivity(Qt::CaseInsensitive);
+  identCompleter->setCompletionMode(QCompleter::PopupCompletion);
+
+  // Installed after the filter of the completer to be called first
+  identCompleter->popup()->installEventFilter(this);
+
+  connect(identCompleter, static_cast<void (QCompleter::*)(const QString&)>(&QCompleter::activated),
+          this, &RouteStringDialog::insertIdentCompletion);
+  connect(ui->plainTextEditRouteString, &QPlainTextEdit::textChanged, this, &RouteStringDialog::updateIdentCompleter);
 }
 
 RouteStringDialog::~RouteStringDialog()
@@ -121,6 +145,88 @@ RouteStringDialog::~RouteStringDialog()
   delete flightplan;
 }
 
+void RouteStringDialog::updateIdentCompleter()
+{
+  // Only plain idents - no completion for speed and altitude or other instructions
+  static const QRegularExpression IDENT_PREFIX("^[A-Z0-9]+$");
+
+  QPlainTextEdit *textEdit = ui->plainTextEditRouteString;
+
+  // Ignore changes by buttons or clipboard
+  if(!textEdit->hasFocus())
+  {
+    identCompleter->popup()->hide();
+    return;
+  }
+
+  // Get word left of the cursor - cursor has to be at the end of the word
+  QString text = textEdit->toPlainText();
+  int pos = textEdit->textCursor().position();
+  if(pos < text.size() && !text.at(pos).isSpace())
+  {
+    identCompleter->popup()->hide();
+    return;
+  }
+
+  int start = pos;
+  while(start > 0 && !text.at(start - 1).isSpace())
+    start--;
+
+  QString prefix = text.mid(start, pos - start).toUpper();
+  QStringList idents;
+  if(IDENT_PREFIX.match(prefix).hasMatch())
+    idents = NavApp::getMapQuery()->getIdentsByPrefix(prefix, map::AIRPORT | map::VOR | map::NDB | map::WAYPOINT |
+                                                      map::AIRWAY, MAX_COMPLETER_IDENTS);
+
+  if(idents.isEmpty() || (idents.size() == 1 && idents.first() == prefix))
+  {
+    // Nothing found or already complete
+    identCompleter->popup()->hide();
+    return;
+  }
+
+  identCompleterModel->setStringList(idents);
+  identCompleter->setCompletionPrefix(prefix);
+  identCompleter->popup()->setCurrentIndex(identCompleter->completionModel()->index(0, 0));
+
+  // Show popup below the cursor
+  QRect rect = textEdit->cursorRect();
+  rect.setWidth(identCompleter->popup()->sizeHintForColumn(0) +
+                identCompleter->popup()->verticalScrollBar()->sizeHint().width());
+  identCompleter->complete(rect);
+}
+
+void RouteStringDialog::insertIdentCompletion(const QString& ident)
+{
+  QPlainTextEdit *textEdit = ui->plainTextEditRouteString;
+  QTextCursor cursor = textEdit->textCursor();
+
+  // Replace the prefix and add a separator to the next word
+  cursor.movePosition(QTextCursor::Left, QTextCursor::KeepAnchor, identCompleter->completionPrefix().size());
+  cursor.insertText(ident + " ");
+  textEdit->setTextCursor(cursor);
+}
+
+bool RouteStringDialog::eventFilter(QObject *object, QEvent *event)
+{
+  if(object == identCompleter->popup() && event->type() == QEvent::KeyPress)
+  {
+    // The completer passes these keys to the text edit first which would insert a line break or tab
+    int key = static_cast<QKeyEvent *>(event)->key();
+    if(key == Qt::Key_Return || key == Qt::Key_Enter || key == Qt::Key_Tab)
+    {
+      QModelIndex index = identCompleter->popup()->currentIndex();
+      if(index.isValid())
+      {
+        identCompleter->popup()->hide();
+        insertIdentCompletion(index.data().toString());
+        return true;
+      }
+    }
+  }
+  return QDialog::eventFilter(object, event);
+}
+
 void RouteStringDialog::updateButtonClicked()
 {
   ui->plainTextEditRouteString->setPlainText(RouteString::createStringForRoute(NavApp::getRouteConst(),
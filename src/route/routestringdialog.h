@@ -36,6 +36,8 @@ class Flightplan;
 
 class MapQuery;
 class QAbstractButton;
+class QCompleter;
+class QStringListModel;
 class RouteController;
 class RouteString;
 
@@ -77,6 +79,15 @@ private:
   void toolButtonOptionTriggered(QAction *action);
   void updateButtonClicked();
 
+  /* Show completer popup for the ident left of the cursor */
+  void updateIdentCompleter();
+
+  /* Replace the ident prefix left of the cursor with the completed ident */
+  void insertIdentCompletion(const QString& ident);
+
+  /* Catches return and tab in the completer popup */
+  virtual bool eventFilter(QObject *object, QEvent *event) override;
+
   Ui::RouteStringDialog *ui;
   atools::fs::pln::Flightplan *flightplan = nullptr;
   MapQuery *mapQuery = nullptr;
@@ -86,6 +97,9 @@ private:
   bool altitudeIncluded = false;
   rs::RouteStringOptions options = rs::DEFAULT_OPTIONS;
 
+  QCompleter *identCompleter = nullptr;
+  QStringListModel *identCompleterModel = nullptr;
+
   void updateFlightplan();
 
 };
@@ -284,6 +284,8 @@ void AirportSearch::connectSearchSlots()
   installEventFilterForWidget(ui->lineEditAirportNameSearch);
   installEventFilterForWidget(ui->lineEditAirportStateSearch);
 
+  installIdentCompleter(ui->lineEditAirportIcaoSearch, map::AIRPORT);
+
   // Runways
   columns->assignMinMaxWidget("longest_runway_length",
                               ui->spinBoxAirportRunwaysMinSearch,
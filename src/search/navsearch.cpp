@@ -212,6 +212,9 @@ void NavSearch::connectSearchSlots()
   installEventFilterForWidget(ui->lineEditNavRegionSearch);
   installEventFilterForWidget(ui->lineEditNavAirportIcaoSearch);
 
+  installIdentCompleter(ui->lineEditNavIcaoSearch, map::VOR | map::NDB | map::WAYPOINT);
+  installIdentCompleter(ui->lineEditNavAirportIcaoSearch, map::AIRPORT);
+
   // Distance
   columns->assignDistanceSearchWidgets(ui->checkBoxNavDistSearch,
                                        ui->comboBoxNavDistDirectionSearch,
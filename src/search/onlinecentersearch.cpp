@@ -78,6 +78,9 @@ OnlineCenterSearch::OnlineCenterSearch(QMainWindow *parent, QTableView *tableVie
 
   SearchBaseTable::initViewAndController(NavApp::getDatabaseOnline());
 
+  // Ids change with each download - keep selection by callsign
+  controller->setKeyColumn("callsign");
+
   // Add model data handler and model format handler as callbacks
   setCallbacks();
 }
@@ -76,6 +76,9 @@ OnlineClientSearch::OnlineClientSearch(QMainWindow *parent, QTableView *tableVie
 
   SearchBaseTable::initViewAndController(NavApp::getDatabaseOnline());
 
+  // Ids change with each download - keep selection by callsign
+  controller->setKeyColumn("callsign");
+
   // Add model data handler and model format handler as callbacks
   setCallbacks();
 }
@@ -35,12 +35,14 @@
 #include "common/unit.h"
 #include "sql/sqlrecord.h"
 
-#include <QTimer>
 #include <QClipboard>
 #include <QKeyEvent>
+#include <QCompleter>
+#include <QStringListModel>
+#include <QRegularExpression>
 
-/* When using distance search delay the update the table after 500 milliseconds */
-const int DISTANCE_EDIT_UPDATE_TIMEOUT_MS = 500;
+/* Maximum number of idents shown in the completer popup */
+const int MAX_COMPLETER_IDENTS = 50;
 
 class ViewEventFilter :
   public QObject
@@ -146,10 +148,6 @@ SearchBaseTable::SearchBaseTable(QMainWindow *parent, QTableView *tableView, Col
   tableView->addActions({ui->actionSearchTableCopy, ui->actionSearchShowInformation, ui->actionSearchShowApproaches,
                          ui->actionSearchShowOnMap, ui->actionSearchTableSelectNothing});
 
-  // Update single shot timer
-  updateTimer = new QTimer(this);
-  updateTimer->setSingleShot(true);
-  connect(updateTimer, &QTimer::timeout, this, &SearchBaseTable::editTimeout);
   connect(ui->actionSearchShowInformation, &QAction::triggered, this, &SearchBaseTable::showInformationTriggered);
   connect(ui->actionSearchShowApproaches, &QAction::triggered, this, &SearchBaseTable::showApproachesTriggered);
   connect(ui->actionSearchShowOnMap, &QAction::triggered, this, &SearchBaseTable::showOnMapTriggered);
@@ -168,7 +166,6 @@ SearchBaseTable::~SearchBaseTable()
   view->removeEventFilter(viewEventFilter);
   delete controller;
   delete csvExporter;
-  delete updateTimer;
   delete zoomHandler;
   delete columns;
   delete viewEventFilter;
@@ -191,21 +188,31 @@ void SearchBaseTable::tableCopyClipboard()
     QString csv;
     SqlController *c = controller;
 
+    // Copying large selections can take a while
+    QGuiApplication::setOverrideCursor(Qt::WaitCursor);
+
     int exported = 0;
     if(controller->hasColumn("lonx") && controller->hasColumn("laty"))
     {
       // Full CSV export including coordinates and full rows
+      // Look up column indexes only once and not for each row
+      const atools::sql::SqlRecord record = controller->getSqlModel()->getSqlRecord();
+      int lonxCol = record.indexOf("lonx"), latyCol = record.indexOf("laty");
+      QLocale locale;
+
       exported = CsvExporter::selectionAsCsv(view, true /* header */, true /* rows */, csv, {"longitude", "latitude"},
-                                             [c](int index) -> QStringList
+                                             [c, lonxCol, latyCol, locale](int index) -> QStringList
       {
-        return {QLocale().toString(c->getRawData(index, "lonx").toFloat(), 'f', 8),
-                QLocale().toString(c->getRawData(index, "laty").toFloat(), 'f', 8)};
+        return {locale.toString(c->getRawData(index, lonxCol).toFloat(), 'f', 8),
+                locale.toString(c->getRawData(index, latyCol).toFloat(), 'f', 8)};
       });
     }
     else
       // Copy only selected cells
       exported = CsvExporter::selectionAsCsv(view, false /* header */, false /* rows */, csv);
 
+    QGuiApplication::restoreOverrideCursor();
+
     if(!csv.isEmpty())
       QApplication::clipboard()->setText(csv);
 
@@ -262,6 +269,8 @@ void SearchBaseTable::optionsChanged()
 
 void SearchBaseTable::styleChanged()
 {
+  // Colors are cached with the formatted values
+  controller->getSqlModel()->clearDataCache();
   view->update();
 }
 
@@ -291,8 +300,6 @@ void SearchBaseTable::updateDistanceSearch()
                                  static_cast<sqlproxymodel::SearchDirection>(distanceDirWidget->currentIndex()),
                                  Unit::rev(minDistanceWidget->value(), Unit::distNmF),
                                  Unit::rev(maxDistanceWidget->value(), Unit::distNmF));
-
-    controller->loadAllRowsForDistanceSearch();
   }
 }
 
@@ -310,7 +317,6 @@ void SearchBaseTable::connectSearchWidgets()
       {
         controller->filterByLineEdit(col, text);
         updateButtonMenu();
-        editStartTimer();
       });
     }
     else if(col->getComboBoxWidget() != nullptr)
@@ -334,7 +340,6 @@ void SearchBaseTable::connectSearchWidgets()
 
           controller->filterByLineEdit(col, text);
           updateButtonMenu();
-          editStartTimer();
         });
       }
       else
@@ -343,7 +348,6 @@ void SearchBaseTable::connectSearchWidgets()
         {
           controller->filterByComboBox(col, index, index == 0);
           updateButtonMenu();
-          editStartTimer();
         });
       }
     }
@@ -353,7 +357,6 @@ void SearchBaseTable::connectSearchWidgets()
       {
         controller->filterByCheckbox(col, state, col->getCheckBoxWidget()->isTristate());
         updateButtonMenu();
-        editStartTimer();
       });
     }
     else if(col->getSpinBoxWidget() != nullptr)
@@ -362,7 +365,6 @@ void SearchBaseTable::connectSearchWidgets()
       {
         updateFromSpinBox(value, col);
         updateButtonMenu();
-        editStartTimer();
       });
     }
     else if(col->getMinSpinBoxWidget() != nullptr && col->getMaxSpinBoxWidget() != nullptr)
@@ -371,14 +373,12 @@ void SearchBaseTable::connectSearchWidgets()
       {
         updateFromMinSpinBox(value, col);
         updateButtonMenu();
-        editStartTimer();
       });
 
       connect(col->getMaxSpinBoxWidget(), valueChangedPtr, [ = ](int value)
       {
         updateFromMaxSpinBox(value, col);
         updateButtonMenu();
-        editStartTimer();
       });
     }
   }
@@ -403,7 +403,6 @@ void SearchBaseTable::connectSearchWidgets()
 
       maxDistanceWidget->setMinimum(value > 10 ? value : 10);
       updateButtonMenu();
-      editStartTimer();
     });
 
     connect(maxDistanceWidget, valueChangedPtr, [ = ](int value)
@@ -414,7 +413,6 @@ void SearchBaseTable::connectSearchWidgets()
         Unit::rev(value, Unit::distNmF));
       minDistanceWidget->setMaximum(value);
       updateButtonMenu();
-      editStartTimer();
     });
 
     connect(distanceDirWidget, curIndexChangedPtr, [ = ](int index)
@@ -423,7 +421,6 @@ void SearchBaseTable::connectSearchWidgets()
                                          Unit::rev(minDistanceWidget->value(), Unit::distNmF),
                                          Unit::rev(maxDistanceWidget->value(), Unit::distNmF));
       updateButtonMenu();
-      editStartTimer();
     });
   }
 }
@@ -494,8 +491,6 @@ void SearchBaseTable::distanceSearchChanged(bool checked, bool changeViewState)
   minDistanceWidget->setEnabled(checked);
   maxDistanceWidget->setEnabled(checked);
   distanceDirWidget->setEnabled(checked);
-  if(checked)
-    controller->loadAllRowsForDistanceSearch();
   restoreViewState(checked);
   updateButtonMenu();
 }
@@ -505,22 +500,27 @@ void SearchBaseTable::installEventFilterForWidget(QWidget *widget)
   widget->installEventFilter(widgetEventFilter);
 }
 
-/* Search criteria editing has started. Start or restart the timer for a
- * delayed update if distance search is used */
-void SearchBaseTable::editStartTimer()
+void SearchBaseTable::installIdentCompleter(QLineEdit *lineEdit, map::MapObjectTypes types)
 {
-  if(controller->isDistanceSearch())
+  // Only plain idents - no completion for placeholders or negated searches
+  static const QRegularExpression IDENT_PREFIX("^[A-Z0-9]+$");
+
+  QStringListModel *completerModel = new QStringListModel(lineEdit);
+
+  // Connect before setting the completer to have the list updated before the completer filters it
+  connect(lineEdit, &QLineEdit::textEdited, [ = ](const QString& text)
   {
-    qDebug() << "editStarted";
-    updateTimer->start(DISTANCE_EDIT_UPDATE_TIMEOUT_MS);
-  }
-}
+    QString prefix = text.toUpper();
+    if(IDENT_PREFIX.match(prefix).hasMatch())
+      completerModel->setStringList(mapQuery->getIdentsByPrefix(prefix, types, MAX_COMPLETER_IDENTS));
+    else
+      completerModel->setStringList(QStringList());
+  });
 
-/* Delayed update timeout. Update result if distance search is active */
-void SearchBaseTable::editTimeout()
-{
-  qDebug() << "editTimeout";
-  controller->loadAllRowsForDistanceSearch();
+  QCompleter *completer = new QCompleter(completerModel, lineEdit);
+  completer->setCaseSensitivity(Qt::CaseInsensitive);
+  completer->setCompletionMode(QCompleter::PopupCompletion);
+  lineEdit->setCompleter(completer);
 }
 
 void SearchBaseTable::connectSearchSlots()
@@ -539,6 +539,10 @@ void SearchBaseTable::connectSearchSlots()
   void (SearchBaseTable::*selChangedPtr)() = &SearchBaseTable::tableSelectionChanged;
   connect(controller->getSqlModel(), &SqlModel::fetchedMore, this, selChangedPtr);
 
+  // Update row counts when a delayed query from a line edit or the delayed row count arrives
+  connect(controller->getSqlModel(), &SqlModel::modelReset, this, selChangedPtr);
+  connect(controller->getSqlModel(), &SqlModel::totalRowCountUpdated, this, selChangedPtr);
+
   connect(ui->dockWidgetSearch, &QDockWidget::visibilityChanged, this, &SearchBaseTable::dockVisibilityChanged);
 }
 
@@ -655,6 +659,11 @@ int SearchBaseTable::getTotalRowCount() const
   return controller->getTotalRowCount();
 }
 
+bool SearchBaseTable::isTotalRowCountValid() const
+{
+  return controller->isTotalRowCountValid();
+}
+
 int SearchBaseTable::getSelectedRowCount() const
 {
   QItemSelectionModel *sm = view->selectionModel();
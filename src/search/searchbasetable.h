@@ -31,7 +31,6 @@ class QMainWindow;
 class QItemSelection;
 class MapQuery;
 class AirportQuery;
-class QTimer;
 class CsvExporter;
 class Column;
 class ViewEventFilter;
@@ -118,8 +117,9 @@ public:
   /* Number of rows currently loaded into the table view */
   int getVisibleRowCount() const;
 
-  /* Total number of rows returned by the last query */
+  /* Total number of rows returned by the last query. Only a lower limit while isTotalRowCountValid is false. */
   int getTotalRowCount() const;
+  bool isTotalRowCountValid() const;
 
   /* Number of selected rows */
   int getSelectedRowCount() const;
@@ -178,6 +178,9 @@ protected:
 
   void installEventFilterForWidget(QWidget *widget);
 
+  /* Add a completer to the line edit offering idents of the given types from the ident index */
+  void installIdentCompleter(QLineEdit *lineEdit, map::MapObjectTypes types);
+
   /* Table/view controller */
   SqlController *controller = nullptr;
 
@@ -193,12 +196,10 @@ private:
 
   void tableSelectionChanged();
   void resetView();
-  void editStartTimer();
   void doubleClick(const QModelIndex& index);
   void tableSelectionChanged(const QItemSelection& selected, const QItemSelection& deselected);
   void reconnectSelectionModel();
   void getNavTypeAndId(int row, map::MapObjectTypes& navType, int& id);
-  void editTimeout();
 
   void loadAllRowsIntoView();
   void tableCopyClipboard();
@@ -220,9 +221,6 @@ private:
   MapQuery *mapQuery;
   AirportQuery *airportQuery;
 
-  /* Used to delay search when using the time intensive distance search */
-  QTimer *updateTimer;
-
   ViewEventFilter *viewEventFilter = nullptr;
   SearchWidgetEventFilter *widgetEventFilter = nullptr;
 };
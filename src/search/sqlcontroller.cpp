@@ -27,6 +27,8 @@
 #include <QSpinBox>
 #include <QApplication>
 
+#include <algorithm>
+
 using atools::sql::SqlQuery;
 using atools::sql::SqlDatabase;
 
@@ -69,57 +71,83 @@ void SqlController::postDatabaseLoad()
   model->fillHeaderData();
 }
 
+void SqlController::setKeyColumn(const QString& colName)
+{
+  keyColumnName = colName;
+  if(model != nullptr)
+    model->setKeyColumn(colName);
+}
+
 void SqlController::refreshData(bool loadAll, bool keepSelection)
 {
+  if(keepSelection && model->hasKeyColumn())
+  {
+    // Loads all rows in background and changes only modified rows which keeps selection and scroll position
+    model->refreshDataByKey();
+    return;
+  }
+
   QItemSelectionModel *sm = view->selectionModel();
 
-  // Get all selected rows and highest selected row number
+  // Row numbers change with new data - remember selected rows and the top row by key column
+  QString keyColumn = keyColumnName.isEmpty() ? columns->getIdColumnName() : keyColumnName;
+  int keyCol = model->getSqlRecord().indexOf(keyColumn);
+
   int maxRow = 0;
-  QSet<int> rows;
-  if(sm != nullptr && keepSelection)
+  QSet<QString> selectedKeys;
+  QString topKey;
+  if(keyCol != -1 && keepSelection)
   {
-    for(const QModelIndex& index : sm->selectedRows(0))
+    if(sm != nullptr)
     {
-      if(index.row() > maxRow)
-        maxRow = index.row();
-      rows.insert(index.row());
+      for(const QModelIndex& index : sm->selectedRows(0))
+      {
+        maxRow = std::max(maxRow, index.row());
+        selectedKeys.insert(getRawData(index.row(), keyCol).toString());
+      }
     }
+
+    // Scroll position is kept only together with the selection
+    QModelIndex topIndex = view->indexAt(QPoint(0, 0));
+    if(topIndex.isValid())
+      topKey = getRawData(topIndex.row(), keyCol).toString();
   }
 
   // Reload query model
   model->refreshData();
 
-  if(loadAll)
+  // Wait for the worker and load at least as many rows as were needed for the old selection
+  model->waitForRows(loadAll ? -1 : maxRow + 1);
+
+  if(keyCol == -1 || (selectedKeys.isEmpty() && topKey.isEmpty()))
+    return;
+
+  // Find rows in one pass and update selection at once
+  QAbstractItemModel *viewModel = view->model();
+  QItemSelection selection;
+  int topRow = -1;
+  int visibleRowCount = getVisibleRowCount();
+  for(int row = 0; row < visibleRowCount; row++)
   {
-    while(model->canFetchMore())
-      model->fetchMore(QModelIndex());
+    QString key = getRawData(row, keyCol).toString();
+    if(selectedKeys.contains(key))
+      selection.select(viewModel->index(row, 0), viewModel->index(row, 0));
+    if(topRow == -1 && key == topKey)
+      topRow = row;
   }
 
-  // Selection changes when updating model
+  // Selection model changes when updating model
   sm = view->selectionModel();
-
-  if(sm != nullptr && keepSelection)
+  if(sm != nullptr && !selection.isEmpty())
   {
-    int visibleRowCount = getVisibleRowCount();
-
-    // Check if selected rows have to be loaded
-    if(maxRow >= visibleRowCount)
-    {
-      // Load until done or highest selected row is covered
-      while(model->canFetchMore() && getVisibleRowCount() < maxRow)
-        model->fetchMore(QModelIndex());
-    }
-
-    // Update selection in new data result set
-    int totalRowCount = getTotalRowCount();
     sm->blockSignals(true);
-    for(int row : rows)
-    {
-      if(row < totalRowCount)
-        sm->select(model->index(row, 0), QItemSelectionModel::Select | QItemSelectionModel::Rows);
-    }
+    sm->select(selection, QItemSelectionModel::Select | QItemSelectionModel::Rows);
     sm->blockSignals(false);
   }
+
+  // Keep scroll position
+  if(topRow != -1)
+    view->scrollTo(viewModel->index(topRow, 0), QAbstractItemView::PositionAtTop);
 }
 
 void SqlController::refreshView()
@@ -136,14 +164,12 @@ void SqlController::filterIncluding(const QModelIndex& index)
 {
   view->clearSelection();
   model->filterIncluding(toSource(index));
-  searchParamsChanged = true;
 }
 
 void SqlController::filterExcluding(const QModelIndex& index)
 {
   view->clearSelection();
   model->filterExcluding(toSource(index));
-  searchParamsChanged = true;
 }
 
 atools::geo::Pos SqlController::getGeoPos(const QModelIndex& index)
@@ -162,8 +188,7 @@ atools::geo::Pos SqlController::getGeoPos(const QModelIndex& index)
 void SqlController::filterByLineEdit(const Column *col, const QString& text)
 {
   view->clearSelection();
-  model->filter(col, text);
-  searchParamsChanged = true;
+  model->filterDelayed(col, text);
 }
 
 void SqlController::filterBySpinBox(const Column *col, int value)
@@ -174,14 +199,12 @@ void SqlController::filterBySpinBox(const Column *col, int value)
     model->filter(col, QVariant(QVariant::Int));
   else
     model->filter(col, value);
-  searchParamsChanged = true;
 }
 
 void SqlController::filterByRecord(const atools::sql::SqlRecord& record)
 {
   view->clearSelection();
   model->filterByRecord(record);
-  searchParamsChanged = true;
 }
 
 void SqlController::filterByMinMaxSpinBox(const Column *col, int minValue, int maxValue)
@@ -197,7 +220,6 @@ void SqlController::filterByMinMaxSpinBox(const Column *col, int minValue, int m
     maxVal = QVariant(QVariant::Int);
 
   model->filter(col, minVal, maxVal);
-  searchParamsChanged = true;
 }
 
 void SqlController::filterByCheckbox(const Column *col, int state, bool triState)
@@ -222,7 +244,6 @@ void SqlController::filterByCheckbox(const Column *col, int state, bool triState
   }
   else
     model->filter(col, state == Qt::Checked ? 1 : QVariant(QVariant::Int));
-  searchParamsChanged = true;
 }
 
 void SqlController::filterByComboBox(const Column *col, int value, bool noFilter)
@@ -233,7 +254,6 @@ void SqlController::filterByComboBox(const Column *col, int value, bool noFilter
     model->filter(col, QVariant(QVariant::Int));
   else
     model->filter(col, value);
-  searchParamsChanged = true;
 }
 
 void SqlController::filterByDistance(const atools::geo::Pos& center, sqlproxymodel::SearchDirection dir,
@@ -245,7 +265,6 @@ void SqlController::filterByDistance(const atools::geo::Pos& center, sqlproxymod
     view->clearSelection();
 
     currentDistanceCenter = center;
-    atools::geo::Rect rect(center, atools::geo::nmToMeter(maxDistance));
 
     bool proxyWasNull = false;
     if(proxyModel == nullptr)
@@ -263,8 +282,8 @@ void SqlController::filterByDistance(const atools::geo::Pos& center, sqlproxymod
     // Update distances in proxy to get precise radius filtering (second filter stage)
     proxyModel->setDistanceFilter(center, dir, minDistance, maxDistance);
 
-    // Update rectangle filter in query model (first coarse filter stage)
-    model->filterByBoundingRect(rect);
+    // Update rectangle and approximated radius filter in query model (first coarse filter stage)
+    model->filterByDistance(center, dir, minDistance, maxDistance);
 
     if(proxyWasNull)
     {
@@ -290,11 +309,10 @@ void SqlController::filterByDistance(const atools::geo::Pos& center, sqlproxymod
       proxyModel = nullptr;
     }
 
-    model->filterByBoundingRect(atools::geo::Rect());
+    model->filterByDistance(atools::geo::Pos(), sqlproxymodel::ALL, 0.f, 0.f);
     model->fillHeaderData();
     processViewColumns();
   }
-  searchParamsChanged = true;
 }
 
 void SqlController::filterByDistanceUpdate(sqlproxymodel::SearchDirection dir, float minDistance,
@@ -303,14 +321,11 @@ void SqlController::filterByDistanceUpdate(sqlproxymodel::SearchDirection dir, f
   if(proxyModel != nullptr)
   {
     view->clearSelection();
-    // Create new bounding rectangle for first stage search
-    atools::geo::Rect rect(currentDistanceCenter, atools::geo::nmToMeter(maxDistance));
 
     // Update proxy second stage filter
     proxyModel->setDistanceFilter(currentDistanceCenter, dir, minDistance, maxDistance);
     // Update SQL model coarse first stage filter
-    model->filterByBoundingRect(rect);
-    searchParamsChanged = true;
+    model->filterByDistance(currentDistanceCenter, dir, minDistance, maxDistance);
   }
 }
 
@@ -353,10 +368,21 @@ int SqlController::getVisibleRowCount() const
   return 0;
 }
 
+bool SqlController::isTotalRowCountValid() const
+{
+  if(proxyModel != nullptr)
+    // Proxy knows the precise count only if all rows are loaded
+    return !model->canFetchMore(QModelIndex()) && model->isTotalRowCountValid();
+  else if(model != nullptr)
+    return model->isTotalRowCountValid();
+  else
+    return true;
+}
+
 int SqlController::getTotalRowCount() const
 {
   if(proxyModel != nullptr)
-    // Proxy fine second stage filter knows precise count
+    // Proxy fine second stage filter knows precise count - lower limit while rows are loaded
     return proxyModel->rowCount();
   else if(model != nullptr)
     return model->getTotalRowCount();
@@ -520,6 +546,7 @@ void SqlController::updateHeaderData()
 void SqlController::prepareModel()
 {
   model = new SqlModel(parentWidget, db, columns);
+  model->setKeyColumn(keyColumnName);
 
   viewSetModel(model);
 
@@ -527,27 +554,6 @@ void SqlController::prepareModel()
   processViewColumns();
 }
 
-void SqlController::loadAllRowsForDistanceSearch()
-{
-  if(searchParamsChanged && proxyModel != nullptr)
-  {
-    QGuiApplication::setOverrideCursor(Qt::WaitCursor);
-
-    // Run query again
-    model->resetSqlQuery();
-
-    // Let proxy know that filter parameters have changed
-    proxyModel->invalidate();
-
-    while(model->canFetchMore())
-      // Fetch as long as we can
-      model->fetchMore(QModelIndex());
-
-    QGuiApplication::restoreOverrideCursor();
-    searchParamsChanged = false;
-  }
-}
-
 void SqlController::setDataCallback(const SqlModel::DataFunctionType& value,
                                     const QSet<Qt::ItemDataRole>& roles)
 {
@@ -558,17 +564,8 @@ void SqlController::loadAllRows()
 {
   QGuiApplication::setOverrideCursor(Qt::WaitCursor);
 
-  if(proxyModel != nullptr)
-  {
-    // Run query again
-    model->resetSqlQuery();
-
-    // Let proxy know that filter parameters have changed
-    proxyModel->invalidate();
-  }
-
-  while(model->canFetchMore())
-    model->fetchMore(QModelIndex());
+  // Proxy filters the rows as they arrive
+  model->waitForRows(-1);
 
   QGuiApplication::restoreOverrideCursor();
 }
@@ -91,6 +91,9 @@ public:
   /* Total number of rows returned by the last query */
   int getTotalRowCount() const;
 
+  /* False if the total row count is still being determined and getTotalRowCount returns a lower limit */
+  bool isTotalRowCountValid() const;
+
   /* Get the SQL query that was used to populate the table */
   QString getCurrentSqlQuery() const;
 
@@ -140,9 +143,6 @@ public:
   /* Update distance search for changed values from spin box widgets */
   void filterByDistanceUpdate(sqlproxymodel::SearchDirection dir, float minDistance, float maxDistance);
 
-  /* Load all rows if a distance search is active. */
-  void loadAllRowsForDistanceSearch();
-
   /* True if distance search is active */
   bool isDistanceSearch()
   {
@@ -173,9 +173,15 @@ public:
 
   void updateHeaderData();
 
-  /* Update query on changes in the database. Loads all data needed to restore selection if keepSelection is true */
+  /* Update query on changes in the database. Loads all data needed to restore selection if keepSelection is true.
+   * Selection and scroll position are restored using the key column.
+   * If a key column was set and keepSelection is true only the changed rows are updated in the background. */
   void refreshData(bool loadAll, bool keepSelection);
 
+  /* Column which identifies a row across refreshes. Defaults to the id column. Needed if ids are not stable
+   * like for online clients. Enables updating of changed rows only in refreshData. */
+  void setKeyColumn(const QString& colName);
+
   /* Update view only */
   void refreshView();
 
@@ -196,10 +202,8 @@ private:
   QModelIndex fromSource(const QModelIndex& index) const;
 
   /* Proxy model used to distance search. null if distance search is not active.
-   * While the normal SQL model acts as a primary (rectangle based) filter the proxy
-   * model will do proper min/max radius filtering at a secondary stage.
-   * To get correct results all rows have to be loaded from the SQL model and have to be piped through the
-   * proxy model. */
+   * While the normal SQL model acts as a primary (rectangle and approximated radius based) filter the proxy
+   * model will do exact min/max radius filtering at a secondary stage for the loaded rows. */
   SqlProxyModel *proxyModel = nullptr;
 
   SqlModel *model = nullptr;
@@ -208,11 +212,10 @@ private:
   QTableView *view = nullptr;
   ColumnList *columns = nullptr;
 
-  /* The model query is executed immediately if distance search is not used. For distance search
-   * use a delayed approach that checks if any query parameters are changed. Changed parameters
-   * are indicated by this bool */
-  bool searchParamsChanged = false;
   atools::geo::Pos currentDistanceCenter;
+
+  /* Used to restore selection in refreshData. Id column if empty. */
+  QString keyColumnName;
 };
 
 #endif // LITTLENAVMAP_CONTROLLER_H
@@ -21,33 +21,82 @@
 #include "gui/errorhandler.h"
 #include "search/columnlist.h"
 #include "sql/sqldatabase.h"
-#include "sql/sqlquery.h"
-#include "exception.h"
 #include "search/column.h"
 #include "sql/sqlrecord.h"
+#include "sql/sqlutil.h"
+#include "db/dbtypes.h"
+#include "geo/calculations.h"
 
 #include <QLineEdit>
 #include <QCheckBox>
 #include <QSqlError>
+#include <QSqlField>
 #include <QRegularExpression>
 #include <QComboBox>
+#include <QTimer>
+#include <QThread>
+
+#include <algorithm>
+#include <cmath>
 
-using atools::sql::SqlQuery;
 using atools::sql::SqlDatabase;
 using atools::gui::ErrorHandler;
 using atools::sql::SqlRecord;
 
+/* Delay for filterDelayed */
+const int QUERY_DELAY_MS = 250;
+
+/* The radius range in the distance search query is widened by this factor so that the flat earth
+ * approximation does not drop objects which are within the exact range */
+const float DISTANCE_TOLERANCE = 0.1f;
+
+/* Radius and direction are filtered only by SqlProxyModel beyond these limits where the approximation
+ * gets too inaccurate */
+const float MAX_APPROX_DISTANCE_NM = 1000.f;
+const float MAX_APPROX_LATY = 80.f;
+
+/* Direction ranges in the query are this angle wider on each side than the exact ones in SqlProxyModel */
+const float DIR_RANGE_DEG = 22.5f, DIR_TOLERANCE_DEG = 10.f;
+
+/* Fixed format to avoid exponents and localized numbers in queries */
+static QString sqlNumber(double value)
+{
+  return QString::number(value, 'f', 8);
+}
+
+/* Maximum number of cells in the formatted value cache */
+const int DATA_CACHE_SIZE = 50000;
+
 SqlModel::SqlModel(QWidget *parent, SqlDatabase *sqlDb, const ColumnList *columnList)
-  : QSqlQueryModel(parent), db(sqlDb), columns(columnList), parentWidget(parent)
+  : QAbstractTableModel(parent), db(sqlDb), columns(columnList), parentWidget(parent), dataCache(DATA_CACHE_SIZE)
 {
   // Set default handler
   setDataCallback(nullptr, QSet<Qt::ItemDataRole>());
 
+  queryTimer = new QTimer(this);
+  queryTimer->setSingleShot(true);
+  connect(queryTimer, &QTimer::timeout, this, &SqlModel::buildQuery);
+
+  // Worker is deleted in its thread when finished
+  worker = new SqlQueryWorker;
+  workerThread = new QThread(this);
+  workerThread->setObjectName("SqlQueryWorker " + columns->getTablename());
+  worker->moveToThread(workerThread);
+  connect(workerThread, &QThread::finished, worker, &QObject::deleteLater);
+  connect(worker, &SqlQueryWorker::pagesAvailable, this, &SqlModel::processPages, Qt::QueuedConnection);
+  workerThread->start();
+
   buildQuery();
 }
 
 SqlModel::~SqlModel()
 {
+  // Drop all requests and interrupt a running query
+  worker->cancel(++queryGeneration);
+
+  workerThread->quit();
+  workerThread->wait();
+  worker = nullptr;
 }
 
 void SqlModel::filterIncluding(QModelIndex index)
@@ -62,9 +111,18 @@ void SqlModel::filterExcluding(QModelIndex index)
   buildQuery();
 }
 
-void SqlModel::filterByBoundingRect(const atools::geo::Rect& boundingRectangle)
+void SqlModel::filterByDistance(const atools::geo::Pos& center, sqlproxymodel::SearchDirection dir,
+                                float minDistance, float maxDistance)
 {
-  boundingRect = boundingRectangle;
+  distanceCenter = center;
+  distanceDirection = dir;
+  minDistanceNm = minDistance;
+  maxDistanceNm = maxDistance;
+
+  if(center.isValid())
+    boundingRect = atools::geo::Rect(center, atools::geo::nmToMeter(maxDistance));
+  else
+    boundingRect = atools::geo::Rect();
   buildQuery();
 }
 
@@ -78,7 +136,7 @@ void SqlModel::filterByRecord(const atools::sql::SqlRecord& record)
 void SqlModel::filterBy(QModelIndex index, bool exclude)
 {
   QString whereCol = getSqlRecord().fieldName(index.column());
-  filterBy(exclude, whereCol, QSqlQueryModel::data(index));
+  filterBy(exclude, whereCol, rawData(index, Qt::DisplayRole));
 }
 
 /* Simple include/exclude filter. Updates the attached search widgets */
@@ -132,8 +190,20 @@ void SqlModel::filterBy(bool exclude, QString whereCol, QVariant whereValue)
   whereConditionMap.insert(whereCol, {whereOp, whereValue, whereValue, colDescr});
 }
 
-/* Changes the whereConditionMap. Removes, replaces or adds where conditions based on input */
 void SqlModel::filter(const Column *col, const QVariant& value, const QVariant& maxValue)
+{
+  updateWhereCondition(col, value, maxValue);
+  buildQuery();
+}
+
+void SqlModel::filterDelayed(const Column *col, const QVariant& value)
+{
+  updateWhereCondition(col, value, QVariant());
+  queryTimer->start(QUERY_DELAY_MS);
+}
+
+/* Changes the whereConditionMap. Removes, replaces or adds where conditions based on input */
+void SqlModel::updateWhereCondition(const Column *col, const QVariant& value, const QVariant& maxValue)
 {
   Q_ASSERT(col != nullptr);
   QString colName = col->getColumnName();
@@ -243,7 +313,6 @@ void SqlModel::filter(const Column *col, const QVariant& value, const QVariant&
       // Insert new condition
       whereConditionMap.insert(colName, {oper, newVariant, value, col});
   }
-  buildQuery();
 }
 
 void SqlModel::setSort(const QString& colname, Qt::SortOrder order)
@@ -268,6 +337,7 @@ void SqlModel::setDataCallback(const DataFunctionType& func, const QSet<Qt::Item
     handlerRoles = roles;
     dataFunction = func;
   }
+  clearDataCache();
 }
 
 void SqlModel::resetSort()
@@ -299,6 +369,7 @@ void SqlModel::clearWhereConditions()
 {
   whereConditionMap.clear();
   boundingRect = atools::geo::Rect();
+  distanceCenter = atools::geo::Pos();
 }
 
 /* Set header captions */
@@ -353,7 +424,7 @@ void SqlModel::sort(int column, Qt::SortOrder order)
 }
 
 /* Build full list of columns to query */
-QString SqlModel::buildColumnList(const atools::sql::SqlRecord& tableCols)
+QString SqlModel::buildColumnList(const atools::sql::SqlRecord& tableCols, QSqlRecord& record)
 {
   QVector<QString> colNames;
   for(const Column *col : columns->getColumns())
@@ -366,10 +437,16 @@ QString SqlModel::buildColumnList(const atools::sql::SqlRecord& tableCols)
     }
 
     if(col->isDistance())
+    {
       // Add null for special distance columns
       colNames.append("null as " + col->getColumnName());
+      record.append(QSqlField(col->getColumnName(), QVariant::Double));
+    }
     else
+    {
       colNames.append(col->getColumnName());
+      record.append(QSqlField(col->getColumnName(), tableCols.fieldType(tableCols.indexOf(col->getColumnName()))));
+    }
   }
 
   // Concatenate to one string
@@ -389,16 +466,47 @@ QString SqlModel::buildColumnList(const atools::sql::SqlRecord& tableCols)
 /* Create SQL query and set it into the model */
 void SqlModel::buildQuery()
 {
+  // Any pending delayed query is covered by this one
+  queryTimer->stop();
+
+  // Sort column changes background colors also with the distance search proxy
+  clearDataCache();
+
   atools::sql::SqlRecord tableCols = db->record(columns->getTablename());
-  QString queryCols = buildColumnList(tableCols);
+  QSqlRecord record;
+  QString queryCols = buildColumnList(tableCols, record);
+
+  if(record != queryRecord)
+  {
+    // Columns have changed after loading another database - rows do not fit anymore
+    beginResetModel();
+    queryRecord = record;
+    rows.clear();
+    rowsGeneration = 0;
+    headerCaptions.clear();
+    endResetModel();
+  }
+
+  // Database might have changed since last query
+  updateIndexTables();
 
   QVector<const Column *> overrideColumns;
   QString queryWhere = buildWhere(tableCols, overrideColumns);
 
   QString queryOrder;
   const Column *col = columns->getColumn(orderByCol);
-  // Distance columns are no search criteria
-  if(!orderByCol.isEmpty() && !orderByOrder.isEmpty() && !col->isDistance())
+  if(!orderByCol.isEmpty() && !orderByOrder.isEmpty() && col->isDistance())
+  {
+    // Sort by approximated distance or heading - the proxy model keeps this order
+    if(distanceCenter.isValid() && !overrideModeActive)
+    {
+      if(orderByCol == "distance")
+        queryOrder += "order by " + buildDistanceExpression() + " " + orderByOrder;
+      else if(orderByCol == "heading")
+        queryOrder += "order by " + buildHeadingExpression() + " " + orderByOrder;
+    }
+  }
+  else if(!orderByCol.isEmpty() && !orderByOrder.isEmpty())
   {
     Q_ASSERT(col != nullptr);
 
@@ -425,7 +533,6 @@ void SqlModel::buildQuery()
                     " " + queryWhere + " " + queryOrder;
 
   // Build a query to find the total row count of the result
-  totalRowCount = 0;
   currentSqlCountQuery = "select count(1) from " + columns->getTablename() + " " + queryWhere;
 
 #ifdef DEBUG_INFORMATION
@@ -440,38 +547,8 @@ void SqlModel::buildQuery()
   }
   emit overrideMode(overrideColumnTitles);
 
-  try
-  {
-    // Count total rows
-    updateTotalCount();
-
-    if(!boundingRect.isValid())
-      // Delay query for bounding rectangle query with proxy model
-      resetSqlQuery();
-  }
-  catch(atools::Exception& e)
-  {
-    ATOOLS_HANDLE_EXCEPTION(e);
-  }
-  catch(...)
-  {
-    ATOOLS_HANDLE_UNKNOWN_EXCEPTION;
-  }
-}
-
-void SqlModel::updateTotalCount()
-{
-  if(!currentSqlCountQuery.isEmpty())
-  {
-    SqlQuery countStmt(db);
-    countStmt.exec(currentSqlCountQuery);
-    if(countStmt.next())
-      totalRowCount = countStmt.value(0).toInt();
-    else
-      totalRowCount = 0;
-  }
-  else
-    totalRowCount = 0;
+  // Rows are counted by the worker after the first page since the count is not needed if all rows fit into it
+  resetSqlQuery();
 }
 
 /* Build where statement */
@@ -545,39 +622,32 @@ QString SqlModel::buildWhere(const atools::sql::SqlRecord& tableCols, QVector<co
     if(numCond++ > 0)
       queryWhere += " " + WHERE_OPERATOR + " ";
 
-    if(cond.col->isIncludesName())
-      // Condition includes column name
-      queryWhere += " " + cond.oper + " ";
+    if(isTextSearchCondition(cond))
+      // Use the text index instead of a table scan
+      queryWhere += buildTextSearchCondition(cond);
     else
-      queryWhere += cond.col->getColumnName() + " " + cond.oper + " ";
+    {
+      if(cond.col->isIncludesName())
+        // Condition includes column name
+        queryWhere += " " + cond.oper + " ";
+      else
+        queryWhere += cond.col->getColumnName() + " " + cond.oper + " ";
 
-    if(!cond.value.isNull())
-      queryWhere += buildWhereValue(cond);
+      if(!cond.value.isNull())
+        queryWhere += buildWhereValue(cond);
+    }
   }
 
   if(boundingRect.isValid() && !overrideModeActive)
   {
-    QString rectCond;
-    if(boundingRect.crossesAntiMeridian())
-    {
-      QList<atools::geo::Rect> rect = boundingRect.splitAtAntiMeridian();
-
-      rectCond = QString("((lonx between %1 and %2 and laty between %3 and %4) or "
-                         "(lonx between %5 and %6 and laty between %7 and %8))").
-                 arg(rect.at(0).getTopLeft().getLonX()).arg(rect.at(0).getBottomRight().getLonX()).
-                 arg(rect.at(0).getBottomRight().getLatY()).arg(rect.at(0).getTopLeft().getLatY()).
-                 arg(rect.at(1).getTopLeft().getLonX()).arg(rect.at(1).getBottomRight().getLonX()).
-                 arg(rect.at(1).getBottomRight().getLatY()).arg(rect.at(1).getTopLeft().getLatY());
-    }
-    else
-      rectCond = QString("(lonx between %1 and %2 and laty between %3 and %4)").
-                 arg(boundingRect.getTopLeft().getLonX()).arg(boundingRect.getBottomRight().getLonX()).
-                 arg(boundingRect.getBottomRight().getLatY()).arg(boundingRect.getTopLeft().getLatY());
-
     if(numCond > 0)
       queryWhere += " " + WHERE_OPERATOR + " ";
-    queryWhere += rectCond;
+    queryWhere += buildBoundingRectCondition();
     numCond++;
+
+    QString distanceCond = buildDistanceCondition();
+    if(!distanceCond.isEmpty())
+      queryWhere += " " + WHERE_OPERATOR + " " + distanceCond;
   }
 
   if(numCond > 0)
@@ -606,18 +676,433 @@ QString SqlModel::buildWhereValue(const WhereCondition& cond)
   return val;
 }
 
+void SqlModel::updateIndexTables()
+{
+  textSearchTable.clear();
+  textSearchColumns.clear();
+  spatialIndexTable.clear();
+
+  atools::sql::SqlUtil util(db);
+  QString table = dm::textSearchTableName(columns->getTablename());
+  if(util.hasTable(table))
+  {
+    textSearchTable = table;
+    atools::sql::SqlRecord rec = db->record(table);
+    for(int i = 0; i < rec.count(); i++)
+      textSearchColumns.insert(rec.fieldName(i));
+  }
+
+  table = dm::spatialIndexTableName(columns->getTablename());
+  if(util.hasTable(table))
+    spatialIndexTable = table;
+}
+
+QString SqlModel::buildBoundingRectCondition() const
+{
+  QList<atools::geo::Rect> rects;
+  if(boundingRect.crossesAntiMeridian())
+    rects = boundingRect.splitAtAntiMeridian();
+  else
+    rects.append(boundingRect);
+
+  QStringList rectConds;
+  for(const atools::geo::Rect& rect : rects)
+  {
+    if(spatialIndexTable.isEmpty())
+      rectConds.append(QString("(lonx between %1 and %2 and laty between %3 and %4)").
+                       arg(rect.getTopLeft().getLonX()).arg(rect.getBottomRight().getLonX()).
+                       arg(rect.getBottomRight().getLatY()).arg(rect.getTopLeft().getLatY()));
+    else
+      // Overlap query on the R*Tree - one select for each rectangle since SQLite cannot use the
+      // R*Tree index for "or" conditions
+      rectConds.append(QString("select id from %1 where max_lonx >= %2 and min_lonx <= %3 and "
+                               "max_laty >= %4 and min_laty <= %5").
+                       arg(spatialIndexTable).
+                       arg(rect.getTopLeft().getLonX()).arg(rect.getBottomRight().getLonX()).
+                       arg(rect.getBottomRight().getLatY()).arg(rect.getTopLeft().getLatY()));
+  }
+
+  if(spatialIndexTable.isEmpty())
+    return "(" + rectConds.join(" or ") + ")";
+  else
+    return columns->getIdColumnName() + " in (" + rectConds.join(" union ") + ")";
+}
+
+QString SqlModel::buildDistanceCondition() const
+{
+  // Flat earth approximation is not usable for large radius or areas close to the poles
+  if(maxDistanceNm > MAX_APPROX_DISTANCE_NM ||
+     std::abs(distanceCenter.getLatY()) + maxDistanceNm / 60.f > MAX_APPROX_LATY)
+    return QString();
+
+  QStringList conds;
+
+  // Compare squared distances in degree latitude to avoid the square root
+  float maxDeg = maxDistanceNm / 60.f * (1.f + DISTANCE_TOLERANCE);
+  conds.append(buildDistanceExpression() + " <= " + sqlNumber(maxDeg * maxDeg));
+
+  if(minDistanceNm > 0.f)
+  {
+    float minDeg = minDistanceNm / 60.f * (1.f - DISTANCE_TOLERANCE);
+    conds.append(buildDistanceExpression() + " >= " + sqlNumber(minDeg * minDeg));
+  }
+
+  // Direction by comparing the offsets instead of calculating the angle
+  QString dx = buildDeltaXExpression(), dy = buildDeltaYExpression();
+  QString tanRange = sqlNumber(std::tan(atools::geo::toRadians(DIR_RANGE_DEG - DIR_TOLERANCE_DEG)));
+  switch(distanceDirection)
+  {
+    case sqlproxymodel::ALL:
+      break;
+
+    case sqlproxymodel::NORTH:
+      conds.append(QString("%1 >= abs(%2) * %3").arg(dy, dx, tanRange));
+      break;
+
+    case sqlproxymodel::EAST:
+      conds.append(QString("%1 >= abs(%2) * %3").arg(dx, dy, tanRange));
+      break;
+
+    case sqlproxymodel::SOUTH:
+      conds.append(QString("-%1 >= abs(%2) * %3").arg(dy, dx, tanRange));
+      break;
+
+    case sqlproxymodel::WEST:
+      conds.append(QString("-%1 >= abs(%2) * %3").arg(dx, dy, tanRange));
+      break;
+  }
+
+  return "(" + conds.join(" and ") + ")";
+}
+
+QString SqlModel::buildDistanceExpression() const
+{
+  QString dx = buildDeltaXExpression(), dy = buildDeltaYExpression();
+  return QString("(%1 * %1 + %2 * %2)").arg(dx, dy);
+}
+
+QString SqlModel::buildHeadingExpression() const
+{
+  // Pseudo angle clockwise from north in the range 0 to 4 - null at the center
+  QString dx = buildDeltaXExpression(), dy = buildDeltaYExpression();
+  return QString("(case when %1 >= 0 then 1 - %2 / (abs(%1) + abs(%2)) "
+                 "else 3 + %2 / (abs(%1) + abs(%2)) end)").arg(dx, dy);
+}
+
+QString SqlModel::buildDeltaXExpression() const
+{
+  // Longitude difference wrapped at the anti-meridian and scaled by the cosine of the mean latitude.
+  // The cosine is linearized at the center: cos(lat0 + dlat / 2) ~ cos(lat0) - sin(lat0) * dlat / 2
+  double latRad = atools::geo::toRadians(static_cast<double>(distanceCenter.getLatY()));
+  QString dlon = QString("(lonx - %1)").arg(sqlNumber(distanceCenter.getLonX()));
+
+  return QString("((case when %1 > 180 then %1 - 360 when %1 < -180 then %1 + 360 else %1 end) * "
+                 "(%2 - %3 * %4))").
+         arg(dlon, sqlNumber(std::cos(latRad)), sqlNumber(std::sin(latRad) * atools::geo::toRadians(0.5)),
+             buildDeltaYExpression());
+}
+
+QString SqlModel::buildDeltaYExpression() const
+{
+  return QString("(laty - %1)").arg(sqlNumber(distanceCenter.getLatY()));
+}
+
+bool SqlModel::isTextSearchCondition(const WhereCondition& cond) const
+{
+  // Only plain words with a trailing wildcard as created by filter() - anything else needs like
+  const static QRegularExpression TEXT_SEARCH_MATCH("^[\\w ]*\\w[\\w ]*%$",
+                                                      QRegularExpression::UseUnicodePropertiesOption);
+
+  return !textSearchTable.isEmpty() && cond.oper == "like" && !cond.col->isIncludesName() &&
+         textSearchColumns.contains(cond.col->getColumnName()) && cond.value.type() == QVariant::String &&
+         TEXT_SEARCH_MATCH.match(cond.value.toString()).hasMatch() && !cond.value.toString().contains('_');
+}
+
+QString SqlModel::buildTextSearchCondition(const WhereCondition& cond) const
+{
+  // "frank main%" results in "name : "frank"* AND name : "main"*" which finds all words starting with the text
+  QString value = cond.value.toString();
+  value.chop(1);
+
+  QStringList phrases;
+  for(const QString& word : value.split(' ', QString::SkipEmptyParts))
+    phrases.append(cond.col->getColumnName() + " : \"" + word + "\"*");
+
+  QString match = phrases.join(" AND ");
+  return columns->getIdColumnName() + " in (select rowid from " + textSearchTable + " where " +
+         textSearchTable + " match '" + match.replace("'", "''") + "')";
+}
+
 void SqlModel::refreshData()
 {
   resetSqlQuery();
-  updateTotalCount();
+}
+
+void SqlModel::refreshDataByKey()
+{
+  if(keyColumnName.isEmpty() || rowsGeneration != queryGeneration || queryRecord.indexOf(keyColumnName) == -1)
+  {
+    // No rows to compare with - load from scratch
+    resetSqlQuery();
+    return;
+  }
+
+  worker->cancel(++queryGeneration);
+  keyRefreshGeneration = queryGeneration;
+
+  // Get all rows at once to compare
+  totalRowCountValid = false;
+  requestRows(0, -1, false /* blocking */);
+}
+
+void SqlModel::updateRowsByKey(const sqlworker::RowVector& newRows)
+{
+  int keyCol = queryRecord.indexOf(keyColumnName);
+  int lastCol = queryRecord.count() - 1;
+
+  // Formatted values are cached by row number
+  clearDataCache();
+
+  QSet<QString> newKeys;
+  for(const sqlworker::Row& row : newRows)
+    newKeys.insert(row.at(keyCol).toString());
+
+  // Remove vanished rows in blocks starting from the end
+  int row = rows.size() - 1;
+  while(row >= 0)
+  {
+    if(!newKeys.contains(rows.at(row).at(keyCol).toString()))
+    {
+      int last = row;
+      while(row > 0 && !newKeys.contains(rows.at(row - 1).at(keyCol).toString()))
+        row--;
+
+      beginRemoveRows(QModelIndex(), row, last);
+      rows.remove(row, last - row + 1);
+      endRemoveRows();
+    }
+    row--;
+  }
+
+  // Walk through new rows and move, insert or update the model rows to match the order
+  for(int i = 0; i < newRows.size(); i++)
+  {
+    const sqlworker::Row& newRow = newRows.at(i);
+    QString key = newRow.at(keyCol).toString();
+
+    if(i >= rows.size() || rows.at(i).at(keyCol).toString() != key)
+    {
+      // Look for the row further down - it has changed its position due to sort order
+      int found = -1;
+      for(int j = i + 1; j < rows.size(); j++)
+      {
+        if(rows.at(j).at(keyCol).toString() == key)
+        {
+          found = j;
+          break;
+        }
+      }
+
+      if(found != -1)
+      {
+        beginMoveRows(QModelIndex(), found, found, QModelIndex(), i);
+        rows.insert(i, rows.takeAt(found));
+        endMoveRows();
+      }
+      else
+      {
+        // New key
+        beginInsertRows(QModelIndex(), i, i);
+        rows.insert(i, newRow);
+        endInsertRows();
+        continue;
+      }
+    }
+
+    if(rows.at(i) != newRow)
+    {
+      rows[i] = newRow;
+      emit dataChanged(index(i, 0), index(i, lastCol));
+    }
+  }
+
+  if(rows.size() > newRows.size())
+  {
+    // Left over rows with duplicate keys
+    beginRemoveRows(QModelIndex(), newRows.size(), rows.size() - 1);
+    rows.remove(newRows.size(), rows.size() - newRows.size());
+    endRemoveRows();
+  }
+}
+
+void SqlModel::clear()
+{
+  queryTimer->stop();
+
+  // Drop all requests and interrupt a running query
+  worker->cancel(++queryGeneration);
+  fetchPending = false;
+
+  // Release the database file which might be replaced next
+  QMetaObject::invokeMethod(worker, "closeDatabase", Qt::BlockingQueuedConnection);
+
+  beginResetModel();
+  clearDataCache();
+  rows.clear();
+  rowsGeneration = 0;
+  rowsAtEnd = true;
+  endResetModel();
+
+  totalRowCount = 0;
+  totalRowCountValid = true;
+}
+
+void SqlModel::clearDataCache()
+{
+  dataCache.clear();
 }
 
 void SqlModel::resetSqlQuery()
 {
-  QSqlQueryModel::setQuery(currentSqlQuery, db->getQSqlDatabase());
+  startQuery();
+}
+
+void SqlModel::startQuery()
+{
+  // Outdated requests are dropped by the worker and a running outdated query is interrupted
+  worker->cancel(++queryGeneration);
+
+  totalRowCountValid = false;
+  requestRows(0, sqlworker::PAGE_SIZE, false /* blocking */);
+}
+
+void SqlModel::requestRows(int offset, int numRows, bool blocking)
+{
+  fetchPending = true;
+
+  // Count is only needed for the first page
+  QString countQuery = offset == 0 ? currentSqlCountQuery : QString();
+
+  QMetaObject::invokeMethod(worker, "fetchRows", blocking ? Qt::BlockingQueuedConnection : Qt::QueuedConnection,
+                            Q_ARG(qint64, queryGeneration), Q_ARG(QString, getDatabaseFile()),
+                            Q_ARG(QString, currentSqlQuery), Q_ARG(QString, countQuery),
+                            Q_ARG(int, offset), Q_ARG(int, numRows));
+}
+
+void SqlModel::waitForRows(int minRows)
+{
+  // Wait for all requests already sent to the worker
+  QMetaObject::invokeMethod(worker, "sync", Qt::BlockingQueuedConnection);
+  processPages();
+
+  bool current = rowsGeneration == queryGeneration;
+  if(current && (rowsAtEnd || (minRows >= 0 && rows.size() >= minRows)))
+    return;
+
+  int offset = current ? rows.size() : 0;
+  requestRows(offset, minRows < 0 ? -1 : std::max(minRows - offset, sqlworker::PAGE_SIZE), true /* blocking */);
+  processPages();
+}
+
+void SqlModel::processPages()
+{
+  QVector<sqlworker::Page> pages;
+  worker->takePages(pages);
+
+  for(const sqlworker::Page& page : pages)
+  {
+    if(page.generation == queryGeneration)
+      processPage(page);
+    // else outdated
+  }
+}
+
+void SqlModel::processPage(const sqlworker::Page& page)
+{
+  if(page.error.isValid())
+  {
+    if(rowsGeneration != queryGeneration)
+    {
+      // Query failed - do not show rows of the previous query
+      beginResetModel();
+      clearDataCache();
+      rows.clear();
+      rowsGeneration = queryGeneration;
+      endResetModel();
+    }
+    fetchPending = false;
+    rowsAtEnd = true;
+    totalRowCount = rows.size();
+    totalRowCountValid = true;
+    atools::gui::ErrorHandler(parentWidget).handleSqlError(page.error);
+    return;
+  }
+
+  if(page.totalRowCount >= 0)
+  {
+    // Result of the count query
+    if(!totalRowCountValid)
+    {
+      totalRowCount = page.totalRowCount;
+      totalRowCountValid = true;
+      emit totalRowCountUpdated();
+    }
+    return;
+  }
+
+  if(rowsGeneration != queryGeneration)
+  {
+    // First page of a new query - replace all rows
+    if(page.offset != 0)
+      return;
 
-  if(lastError().isValid())
-    atools::gui::ErrorHandler(parentWidget).handleSqlError(lastError());
+    if(page.generation == keyRefreshGeneration && page.atEnd)
+      // Apply only changes to keep selection and scroll position
+      updateRowsByKey(page.rows);
+    else
+    {
+      beginResetModel();
+      clearDataCache();
+      rows = page.rows;
+      endResetModel();
+    }
+    rowsGeneration = queryGeneration;
+    rowsAtEnd = page.atEnd;
+  }
+  else
+  {
+    // Skip rows that are already loaded by a previous request
+    int skip = rows.size() - page.offset;
+    if(skip < 0)
+      return;
+
+    if(skip < page.rows.size())
+    {
+      beginInsertRows(QModelIndex(), rows.size(), rows.size() + page.rows.size() - skip - 1);
+      for(int i = skip; i < page.rows.size(); i++)
+        rows.append(page.rows.at(i));
+      endInsertRows();
+    }
+
+    if(page.offset + page.rows.size() >= rows.size())
+      rowsAtEnd = page.atEnd;
+    emit fetchedMore();
+  }
+
+  fetchPending = false;
+
+  if(rowsAtEnd && !totalRowCountValid)
+  {
+    // All rows loaded before the count query was run or result fits into the first page
+    totalRowCount = rows.size();
+    totalRowCountValid = true;
+    emit totalRowCountUpdated();
+  }
+}
+
+QString SqlModel::getDatabaseFile() const
+{
+  return db->getQSqlDatabase().databaseName();
 }
 
 Qt::SortOrder SqlModel::getSortOrder() const
@@ -646,17 +1131,22 @@ QVariant SqlModel::data(const QModelIndex& index, int role) const
 
   Qt::ItemDataRole dataRole = static_cast<Qt::ItemDataRole>(role);
 
-  // Get the default value for this role. Can be a font, color, etc.
-  QVariant roleValue = QSqlQueryModel::data(index, role);
-
   if(handlerRoles.contains(dataRole))
   {
-    // Callback wants to be called for this role
+    // Callback wants to be called for this role - look into the cache before accessing the query
+    quint64 key = (static_cast<quint64>(index.row()) << 32) |
+                  (static_cast<quint64>(index.column()) << 16) | static_cast<quint64>(role & 0xffff);
+
+    QVariant *cached = dataCache.object(key);
+    if(cached != nullptr)
+      return *cached;
+
+    // Get the default value for this role. Can be a font, color, etc.
+    QVariant roleValue = rawData(index, role);
 
     // Get data to display
-    QVariant dataValue = QSqlQueryModel::data(index, Qt::DisplayRole);
-    QString col = getSqlRecord().fieldName(index.column());
-    const Column *column = columns->getColumn(col);
+    QVariant dataValue = dataRole == Qt::DisplayRole ? roleValue : rawData(index, Qt::DisplayRole);
+    const Column *column = columns->getColumn(queryRecord.fieldName(index.column()));
 
     int row = -1;
     if(!boundingRect.isValid())
@@ -664,16 +1154,62 @@ QVariant SqlModel::data(const QModelIndex& index, int role) const
       row = index.row();
 
     QVariant retval = dataFunction(index.column(), row, column, roleValue, dataValue, dataRole);
-    if(retval.isValid())
-      return retval;
+    if(!retval.isValid())
+      retval = roleValue;
+
+    dataCache.insert(key, new QVariant(retval));
+    return retval;
   }
-  return roleValue;
+  return rawData(index, role);
+}
+
+QVariant SqlModel::rawData(const QModelIndex& index, int role) const
+{
+  if(index.isValid() && (role == Qt::DisplayRole || role == Qt::EditRole))
+    return getRawData(index.row(), index.column());
+
+  return QVariant();
 }
 
 void SqlModel::fetchMore(const QModelIndex& parent)
 {
-  QSqlQueryModel::fetchMore(parent);
-  emit fetchedMore();
+  // Ignore if the rows still belong to the previous query or a page is already on its way
+  if(!parent.isValid() && rowsGeneration == queryGeneration && !rowsAtEnd && !fetchPending)
+    requestRows(rows.size(), sqlworker::PAGE_SIZE, false /* blocking */);
+}
+
+bool SqlModel::canFetchMore(const QModelIndex& parent) const
+{
+  return !parent.isValid() && rowsGeneration == queryGeneration && !rowsAtEnd;
+}
+
+int SqlModel::rowCount(const QModelIndex& parent) const
+{
+  return parent.isValid() ? 0 : rows.size();
+}
+
+int SqlModel::columnCount(const QModelIndex& parent) const
+{
+  return parent.isValid() ? 0 : queryRecord.count();
+}
+
+QVariant SqlModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+  if(orientation == Qt::Horizontal && role == Qt::DisplayRole)
+    return headerCaptions.value(section, queryRecord.fieldName(section));
+
+  return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+bool SqlModel::setHeaderData(int section, Qt::Orientation orientation, const QVariant& value, int role)
+{
+  if(orientation != Qt::Horizontal || (role != Qt::DisplayRole && role != Qt::EditRole) ||
+     section < 0 || section >= queryRecord.count())
+    return false;
+
+  headerCaptions.insert(section, value);
+  emit headerDataChanged(orientation, section, section);
+  return true;
 }
 
 QVariant SqlModel::getRawData(int row, const QString& colname) const
@@ -688,7 +1224,10 @@ void SqlModel::updateSqlQuery()
 
 QVariant SqlModel::getRawData(int row, int col) const
 {
-  return QSqlQueryModel::data(createIndex(row, col));
+  if(row >= 0 && row < rows.size() && col >= 0 && col < rows.at(row).size())
+    return rows.at(row).at(col);
+
+  return QVariant();
 }
 
 QString SqlModel::getColumnName(int col) const
@@ -703,10 +1242,13 @@ QVariant SqlModel::getFormattedFieldData(const QModelIndex& index) const
 
 atools::sql::SqlRecord SqlModel::getSqlRecord() const
 {
-  return atools::sql::SqlRecord(record(), currentSqlQuery);
+  return atools::sql::SqlRecord(queryRecord, currentSqlQuery);
 }
 
 atools::sql::SqlRecord SqlModel::getSqlRecord(int row) const
 {
-  return atools::sql::SqlRecord(record(row), currentSqlQuery);
+  QSqlRecord record(queryRecord);
+  for(int i = 0; i < record.count(); i++)
+    record.setValue(i, getRawData(row, i));
+  return atools::sql::SqlRecord(record, currentSqlQuery);
 }
@@ -19,10 +19,14 @@
 #define LITTLENAVMAP_SQLMODEL_H
 
 #include "geo/rect.h"
+#include "search/sqlproxymodel.h"
+#include "search/sqlqueryworker.h"
 
 #include <functional>
 
-#include <QSqlQueryModel>
+#include <QAbstractTableModel>
+#include <QCache>
+#include <QSqlRecord>
 
 namespace atools {
 namespace sql {
@@ -34,12 +38,18 @@ class SqlRecord;
 
 class Column;
 class ColumnList;
+class QTimer;
+class QThread;
 
 /*
- * Extends the QSqlQueryModel and adds query building based on filters and ordering.
+ * Table model which builds SQL queries based on filters and ordering.
+ *
+ * Queries are executed by a SqlQueryWorker in an own thread. Rows are loaded in pages when the view needs
+ * them and kept in this model. The rows of the previous query stay visible until the first page of the new
+ * one arrives. A new query interrupts a running older one.
  */
 class SqlModel :
-  public QSqlQueryModel
+  public QAbstractTableModel
 {
   Q_OBJECT
 
@@ -79,6 +89,11 @@ public:
    * query */
   void filter(const Column *col, const QVariant& value, const QVariant& maxValue = QVariant());
 
+  /* Same as filter but runs the query after a short delay. Each call restarts the delay so only the
+   * last one of several fast changes like key strokes in a line edit is sent to the worker.
+   * A query still running for a previous key stroke is interrupted. */
+  void filterDelayed(const Column *col, const QVariant& value);
+
   /* Get field data formatted for display as seen in the table view */
   QVariant getFormattedFieldData(const QModelIndex& index) const;
 
@@ -94,9 +109,16 @@ public:
     return orderByColIndex;
   }
 
+  /* Total number of rows for the current query. Number of rows loaded until the delayed count is done. */
   int getTotalRowCount() const
   {
-    return totalRowCount;
+    return totalRowCountValid ? totalRowCount : rows.size();
+  }
+
+  /* False while the total row count is not known yet and getTotalRowCount returns a lower limit */
+  bool isTotalRowCountValid() const
+  {
+    return totalRowCountValid;
   }
 
   QString getCurrentSqlQuery() const
@@ -104,19 +126,40 @@ public:
     return currentSqlQuery;
   }
 
-  /* Fetch more data and emit signal fetchedMore */
+  /* Request the next page from the worker. Signal fetchedMore is sent when the rows are added. */
   virtual void fetchMore(const QModelIndex& parent) override;
+  virtual bool canFetchMore(const QModelIndex& parent) const override;
+
+  virtual int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+  virtual int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+
+  virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+  virtual bool setHeaderData(int section, Qt::Orientation orientation, const QVariant& value,
+                             int role = Qt::EditRole) override;
+
+  /* Blocks until at least minRows rows of the current query are loaded or all rows if minRows is negative.
+   * Also waits for a query that is still running in the worker. */
+  void waitForRows(int minRows);
 
   /* Get unformatted data from the model */
   QVariant getRawData(int row, int col) const;
   QVariant getRawData(int row, const QString& colname) const;
 
-  /* Sets the SQL query into the model. This will start the query and fetch data from the database. */
+  /* Build the SQL query and start it in the worker */
   void updateSqlQuery();
+
+  /* Start the current SQL query again in the worker. Rows are replaced when the first page arrives. */
   void resetSqlQuery();
 
-  /* Set a filter for objects within the given bounding rectangle */
-  void filterByBoundingRect(const atools::geo::Rect& boundingRectangle);
+  /*
+   * Set a filter for objects around center for a distance search or end the distance search if center is not valid.
+   * The query uses a bounding rectangle and a flat earth approximation for radius, direction and sort order.
+   * SqlProxyModel checks the loaded rows against the exact great circle distance.
+   * @param minDistance minimum distance to center point in nautical miles
+   * @param maxDistance maximum distance to center point in nautical miles
+   */
+  void filterByDistance(const atools::geo::Pos& center, sqlproxymodel::SearchDirection dir,
+                        float minDistance, float maxDistance);
 
   QString getColumnName(int col) const;
 
@@ -163,6 +206,29 @@ public:
   /* Update model after data change */
   void refreshData();
 
+  /* Column which identifies a row across refreshes. Enables refreshDataByKey. */
+  void setKeyColumn(const QString& colName)
+  {
+    keyColumnName = colName;
+  }
+
+  bool hasKeyColumn() const
+  {
+    return !keyColumnName.isEmpty();
+  }
+
+  /* Loads all rows of the current query again in the worker and applies only the differences to the model.
+   * Rows are matched by the key column and inserted, removed, moved or changed one by one which keeps
+   * selection and scroll position in the view. Falls back to refreshData if the rows are not complete yet. */
+  void refreshDataByKey();
+
+  /* Clears the model, drops any pending or running query and closes the worker connection */
+  void clear();
+
+  /* Remove all formatted values. Needed if formatting depends on changed options or style.
+   * Cleared automatically if the query changes. */
+  void clearDataCache();
+
 signals:
   /* Emitted when more data was fetched */
   void fetchedMore();
@@ -170,10 +236,10 @@ signals:
   /* One or more columns overrides all other search options */
   void overrideMode(const QStringList& overrideColumnTitles);
 
-private:
-  // Hide the record method
-  using QSqlQueryModel::record;
+  /* Delayed count of all result rows is done */
+  void totalRowCountUpdated();
 
+private:
   struct WhereCondition
   {
     QString oper; /* operator (like, not like) */
@@ -185,16 +251,60 @@ private:
   virtual void sort(int column, Qt::SortOrder order) override;
 
   void filterBy(bool exclude, QString whereCol, QVariant whereValue);
-  QString buildColumnList(const atools::sql::SqlRecord& tableCols);
+  void updateWhereCondition(const Column *col, const QVariant& value, const QVariant& maxValue);
+  /* Fills record with the names and types of the query columns */
+  QString buildColumnList(const atools::sql::SqlRecord& tableCols, QSqlRecord& record);
   QString buildWhere(const atools::sql::SqlRecord& tableCols, QVector<const Column *>& overrideColumns);
   QString buildWhereValue(const WhereCondition& cond);
+
+  /* Detect optional FTS5 text search and R*Tree tables for the current database */
+  void updateIndexTables();
+
+  /* Condition for the bounding rectangle using the R*Tree table if available */
+  QString buildBoundingRectCondition() const;
+
+  /* Radius and direction condition for the distance search. Empty if the approximation is not usable. */
+  QString buildDistanceCondition() const;
+
+  /* Squared approximated distance to the distance search center in degree latitude */
+  QString buildDistanceExpression() const;
+
+  /* Value increasing monotonically with the heading from the distance search center. Not an angle. */
+  QString buildHeadingExpression() const;
+
+  /* Approximated east and north offset from the distance search center in degree latitude */
+  QString buildDeltaXExpression() const;
+  QString buildDeltaYExpression() const;
+
+  /* True if the condition is a simple prefix search on a column of the text search table */
+  bool isTextSearchCondition(const WhereCondition& cond) const;
+
+  /* Build a "rowid in (select ... match ...)" condition using prefix queries */
+  QString buildTextSearchCondition(const WhereCondition& cond) const;
   void buildQuery();
   void clearWhereConditions();
   void filterBy(QModelIndex index, bool exclude);
   QString  sortOrderToSql(Qt::SortOrder order);
   QVariant defaultDataHandler(int colIndex, int rowIndex, const Column *col, const QVariant& roleValue,
                               const QVariant& displayRoleValue, Qt::ItemDataRole role) const;
-  void updateTotalCount();
+
+  /* Unformatted value for display and edit role */
+  QVariant rawData(const QModelIndex& index, int role) const;
+
+  /* Start a new generation for the current query and send it to the worker */
+  void startQuery();
+
+  /* Send a request for numRows rows starting at offset to the worker */
+  void requestRows(int offset, int numRows, bool blocking);
+
+  /* Take pages from worker and add rows to model */
+  void processPages();
+  void processPage(const sqlworker::Page& page);
+
+  /* Change rows to match newRows by using the key column */
+  void updateRowsByKey(const sqlworker::RowVector& newRows);
+
+  QString getDatabaseFile() const;
 
   /* Default - all conditions are combined using "and" */
   const QString WHERE_OPERATOR = "and";
@@ -212,6 +322,18 @@ private:
   /* A bounding rectangle query is used if this is valid */
   atools::geo::Rect boundingRect;
 
+  /* Distance search parameters. Center is valid if distance search is active. */
+  atools::geo::Pos distanceCenter;
+  sqlproxymodel::SearchDirection distanceDirection = sqlproxymodel::ALL;
+  float minDistanceNm = 0.f, maxDistanceNm = 0.f;
+
+  /* FTS5 table and its columns if available. Empty if text columns have to use like */
+  QString textSearchTable;
+  QSet<QString> textSearchColumns;
+
+  /* R*Tree table for coordinates if available. Empty if bounding rectangle has to use between */
+  QString spatialIndexTable;
+
   /* Maps column name to where condition struct */
   QHash<QString, WhereCondition> whereConditionMap;
 
@@ -222,6 +344,42 @@ private:
 
   QWidget *parentWidget;
   int totalRowCount = 0;
+  bool totalRowCountValid = true;
+
+  /* Runs buildQuery for filterDelayed */
+  QTimer *queryTimer = nullptr;
+
+  /* Runs the queries. Lives in workerThread. */
+  SqlQueryWorker *worker = nullptr;
+  QThread *workerThread = nullptr;
+
+  /* Generation of the last query sent to the worker and generation of the query the rows belong to */
+  qint64 queryGeneration = 0, rowsGeneration = 0;
+
+  /* Generation of the last refreshDataByKey query */
+  qint64 keyRefreshGeneration = 0;
+
+  /* Used to match rows in refreshDataByKey */
+  QString keyColumnName;
+
+  /* A page was requested from the worker and did not arrive yet */
+  bool fetchPending = false;
+
+  /* All rows of the query are loaded */
+  bool rowsAtEnd = true;
+
+  /* Column names and types of the query */
+  QSqlRecord queryRecord;
+
+  /* Loaded rows of the query */
+  sqlworker::RowVector rows;
+
+  /* Header captions for horizontal header by column index */
+  QHash<int, QVariant> headerCaptions;
+
+  /* Values returned by the data callback. Key is built from row, column and role. Avoids formatting
+   * the same values again when scrolling or repainting. */
+  mutable QCache<quint64, QVariant> dataCache;
 
   /* Set by buildWhere. Will ignore all other filter options */
   bool overrideModeActive = false;
@@ -29,6 +29,14 @@ using namespace atools::geo;
 SqlProxyModel::SqlProxyModel(QObject *parent, SqlModel *sqlModel)
   : QSortFilterProxyModel(parent), sourceSqlModel(sqlModel)
 {
+  // Connect before the proxy connects itself in setSourceModel so the cache is cleared before filtering again
+  connect(sqlModel, &QAbstractItemModel::modelReset, this, &SqlProxyModel::clearCache);
+
+  // Rows can change their position when the model updates by key
+  connect(sqlModel, &QAbstractItemModel::rowsInserted, this, &SqlProxyModel::clearCache);
+  connect(sqlModel, &QAbstractItemModel::rowsRemoved, this, &SqlProxyModel::clearCache);
+  connect(sqlModel, &QAbstractItemModel::rowsMoved, this, &SqlProxyModel::clearCache);
+  connect(sqlModel, &QAbstractItemModel::dataChanged, this, &SqlProxyModel::clearCache);
 }
 
 SqlProxyModel::~SqlProxyModel()
@@ -41,6 +49,8 @@ void SqlProxyModel::setDistanceFilter(const Pos& center, sqlproxymodel::SearchDi
 {
   minDistMeter = nmToMeter(minDistance);
   maxDistMeter = nmToMeter(maxDistance);
+  if(centerPos != center)
+    clearCache();
   centerPos = center;
   direction = dir;
 }
@@ -48,6 +58,38 @@ void SqlProxyModel::setDistanceFilter(const Pos& center, sqlproxymodel::SearchDi
 void SqlProxyModel::clearDistanceFilter()
 {
   centerPos = Pos();
+  clearCache();
+}
+
+void SqlProxyModel::clearCache()
+{
+  distanceCache.clear();
+}
+
+void SqlProxyModel::calculateRow(int row) const
+{
+  if(row >= distanceCache.size())
+    distanceCache.resize(row + 1);
+
+  DistanceHeading& value = distanceCache[row];
+  if(value.distMeter < 0.f)
+  {
+    Pos pos = buildPos(row);
+    value.distMeter = pos.distanceMeterTo(centerPos);
+    value.heading = normalizeCourse(centerPos.angleDegTo(pos));
+  }
+}
+
+float SqlProxyModel::getDistanceMeter(int row) const
+{
+  calculateRow(row);
+  return distanceCache.at(row).distMeter;
+}
+
+float SqlProxyModel::getHeading(int row) const
+{
+  calculateRow(row);
+  return distanceCache.at(row).heading;
 }
 
 /* Does the filtering by minimum and maximum distance and direction */
@@ -58,63 +100,54 @@ bool SqlProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourcePar
   if(sourceSqlModel->isOverrideModeActive())
     return true;
 
-  Pos pos = buildPos(sourceRow);
-  float heading = normalizeCourse(centerPos.angleDegTo(pos));
+  float distMeter = getDistanceMeter(sourceRow);
+  float heading = getHeading(sourceRow);
 
   switch(direction)
   {
     case sqlproxymodel::ALL:
       // All directions
-      return matchDistance(pos);
+      return matchDistance(distMeter);
 
     case sqlproxymodel::NORTH:
       if(MIN_NORTH_DEG <= heading || heading <= MAX_NORTH_DEG)
-        return matchDistance(pos);
+        return matchDistance(distMeter);
       else
         return false;
 
     case sqlproxymodel::EAST:
       if(MIN_EAST_DEG <= heading && heading <= MAX_EAST_DEG)
-        return matchDistance(pos);
+        return matchDistance(distMeter);
       else
         return false;
 
     case sqlproxymodel::SOUTH:
       if(MIN_SOUTH_DEG <= heading && heading <= MAX_SOUTH_DEG)
-        return matchDistance(pos);
+        return matchDistance(distMeter);
       else
         return false;
 
     case sqlproxymodel::WEST:
       if(MIN_WEST_DEG <= heading && heading <= MAX_WEST_DEG)
-        return matchDistance(pos);
+        return matchDistance(distMeter);
       else
         return false;
   }
   return true;
 }
 
-bool SqlProxyModel::matchDistance(const Pos& pos) const
+bool SqlProxyModel::matchDistance(float distMeter) const
 {
   if(sourceSqlModel->isOverrideModeActive())
     return true;
 
-  float distMeter = pos.distanceMeterTo(centerPos);
   return distMeter >= minDistMeter && distMeter <= maxDistMeter;
 }
 
 void SqlProxyModel::sort(int column, Qt::SortOrder order)
 {
-  QSortFilterProxyModel::sort(column, order);
-
-  // Update query in underlying SQL model
-  sourceSqlModel->setSort(sourceSqlModel->getColumnName(column), order);
-
-  // Fetch all data and set wait cursor
-  QGuiApplication::setOverrideCursor(Qt::WaitCursor);
-  while(canFetchMore(QModelIndex()))
-    fetchMore(QModelIndex());
-  QGuiApplication::restoreOverrideCursor();
+  // Update query in underlying SQL model - distance and heading are sorted in the query too
+  sourceModel()->sort(column, order);
 }
 
 QVariant SqlProxyModel::headerData(int section, Qt::Orientation orientation, int role) const
@@ -122,38 +155,13 @@ QVariant SqlProxyModel::headerData(int section, Qt::Orientation orientation, int
   return sourceModel()->headerData(section, orientation, role);
 }
 
-/* Defines greater and lower than for sorting of the two columns distance and heading */
-bool SqlProxyModel::lessThan(const QModelIndex& sourceLeft, const QModelIndex& sourceRight) const
-{
-  QString leftCol = sourceSqlModel->getColumnName(sourceLeft.column());
-  QString rightCol = sourceSqlModel->getColumnName(sourceRight.column());
-
-  if(leftCol == "distance" && rightCol == "distance")
-  {
-    // Sort by distance
-    float distLeft = buildPos(sourceLeft.row()).distanceMeterTo(centerPos);
-    float distRight = buildPos(sourceRight.row()).distanceMeterTo(centerPos);
-    return distLeft < distRight;
-  }
-  else if(leftCol == "heading" && rightCol == "heading")
-  {
-    // Sort by heading
-    float headingLeft = normalizeCourse(centerPos.angleDegTo(buildPos(sourceLeft.row())));
-    float headingRight = normalizeCourse(centerPos.angleDegTo(buildPos(sourceRight.row())));
-    return headingLeft < headingRight;
-  }
-  else
-    // Let the model do the sorting for other columns
-    return QSortFilterProxyModel::lessThan(sourceLeft, sourceRight);
-}
-
 /* Returns the formatted data for the "distance" and "heading" column */
 QVariant SqlProxyModel::data(const QModelIndex& index, int role) const
 {
   if(sourceSqlModel->getColumnName(index.column()) == "distance")
   {
     if(role == Qt::DisplayRole)
-      return Unit::distMeter(buildPos(mapToSource(index).row()).distanceMeterTo(centerPos), false);
+      return Unit::distMeter(getDistanceMeter(mapToSource(index).row()), false);
     else if(role == Qt::TextAlignmentRole)
       return Qt::AlignRight;
   }
@@ -161,7 +169,7 @@ QVariant SqlProxyModel::data(const QModelIndex& index, int role) const
   {
     if(role == Qt::DisplayRole)
     {
-      float heading = normalizeCourse(centerPos.angleDegTo(buildPos(mapToSource(index).row())));
+      float heading = getHeading(mapToSource(index).row());
       if(heading < map::INVALID_COURSE_VALUE)
         return QLocale().toString(heading, 'f', 0);
       else
@@ -21,6 +21,7 @@
 #include "geo/pos.h"
 
 #include <QSortFilterProxyModel>
+#include <QVector>
 
 class SqlModel;
 
@@ -41,11 +42,10 @@ enum SearchDirection
 }
 
 /*
- * Proxy that does the second stage (fine) filtering for distance searches. The default model does a simple
- * rectangle base query and passes the results to this proxy which filters by minimumn and maximum radius
- * and direction.
- * Dynamic loading on demand (like the SQL model does) does not work with this model. Therefore all results
- * have to be fetched.
+ * Proxy that does the second stage (fine) filtering for distance searches. The SQL model does a rectangle and
+ * flat earth approximation based query which is also sorted by distance or heading. This proxy filters the
+ * loaded rows by exact minimum and maximum radius and direction and keeps the order of the SQL model.
+ * Rows are loaded on demand like in the SQL model.
  */
 class SqlProxyModel :
   public QSortFilterProxyModel
@@ -69,18 +69,25 @@ public:
   /* Clear distance search and stop all filtering */
   void clearDistanceFilter();
 
-  /* Sorts the model by column in the given order and fetches all data from the underlying model. */
+  /* Passes sorting to the SQL model which runs a new query. The proxy itself does not sort. */
   virtual void sort(int column, Qt::SortOrder order) override;
 
 private:
   virtual QVariant data(const QModelIndex& index, int role) const override;
   virtual QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
   virtual bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
-  virtual bool lessThan(const QModelIndex& sourceLeft, const QModelIndex& sourceRight) const override;
 
-  bool matchDistance(const atools::geo::Pos& pos) const;
+  bool matchDistance(float distMeter) const;
   atools::geo::Pos buildPos(int row) const;
 
+  /* Distance to center and heading from center for a source row. Calculated only once per row and query. */
+  float getDistanceMeter(int row) const;
+  float getHeading(int row) const;
+  void calculateRow(int row) const;
+
+  /* Clear distance and heading cache. Called when the query is reset or the center changes. */
+  void clearCache();
+
   /* Direction filter ranges are decreased by this value on each side */
   static float Q_DECL_CONSTEXPR DIR_RANGE_DEG = 22.5f;
 
@@ -95,6 +102,14 @@ private:
   sqlproxymodel::SearchDirection direction;
   float minDistMeter = 0.f, maxDistMeter = 0.f;
 
+  struct DistanceHeading
+  {
+    float distMeter = -1.f /* Not calculated yet if negative */, heading = 0.f;
+  };
+
+  /* Indexed by source row. Avoids calculating great circle distances again for each filter and display call. */
+  mutable QVector<DistanceHeading> distanceCache;
+
 };
 
 #endif // LITTLENAVMAP_SQLPROXYMODEL_H
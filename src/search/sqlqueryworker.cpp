@@ -0,0 +1,250 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "search/sqlqueryworker.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <QSqlDriver>
+#include <QSqlQuery>
+#include <QSqlRecord>
+
+#include <sqlite3.h>
+
+const QString DATABASE_TYPE = "QSQLITE";
+
+/* Number of attempts if a query was hit by an interrupt meant for an older query */
+const int MAX_QUERY_ATTEMPTS = 2;
+
+/* Used to build unique connection names */
+static std::atomic_int workerCounter(0);
+
+SqlQueryWorker::SqlQueryWorker()
+  : latestGeneration(0)
+{
+  connectionName = QString("LNMSEARCHWORKER%1").arg(workerCounter++);
+}
+
+SqlQueryWorker::~SqlQueryWorker()
+{
+  closeDatabase();
+}
+
+void SqlQueryWorker::cancel(qint64 generation)
+{
+  QMutexLocker locker(&mutex);
+
+  if(generation > latestGeneration.load())
+    latestGeneration.store(generation);
+
+  // Stop an outdated query in the middle of sqlite3_step
+  if(handle != nullptr && busyGeneration != 0 && busyGeneration < generation)
+    sqlite3_interrupt(handle);
+}
+
+void SqlQueryWorker::takePages(QVector<sqlworker::Page>& result)
+{
+  QMutexLocker locker(&mutex);
+  result.append(pages);
+  pages.clear();
+}
+
+void SqlQueryWorker::fetchRows(qint64 generation, const QString& databaseFile, const QString& sqlQuery,
+                               const QString& sqlCountQuery, int offset, int numRows)
+{
+  if(isOutdated(generation))
+    // Superseded by a newer query while waiting
+    return;
+
+  sqlworker::Page page;
+  page.generation = generation;
+  page.offset = offset;
+
+  if(!openDatabase(databaseFile, page.error))
+  {
+    addPage(page);
+    return;
+  }
+
+  bool done = false;
+  for(int i = 0; i < MAX_QUERY_ATTEMPTS && !done && !isOutdated(generation); i++)
+  {
+    page.rows.clear();
+    page.error = QSqlError();
+
+    setBusy(generation);
+    done = fetchPage(page, sqlQuery, numRows);
+    setBusy(0);
+  }
+
+  if(isOutdated(generation))
+    return;
+
+  addPage(page);
+
+  if(offset == 0 && !page.atEnd && !page.error.isValid() && !sqlCountQuery.isEmpty())
+  {
+    // Result does not fit into the first page - get total number of rows
+    sqlworker::Page countPage;
+    countPage.generation = generation;
+
+    setBusy(generation);
+    bool counted = countRows(countPage, sqlCountQuery);
+    setBusy(0);
+
+    if(counted && !isOutdated(generation))
+      addPage(countPage);
+  }
+}
+
+void SqlQueryWorker::sync()
+{
+}
+
+bool SqlQueryWorker::fetchPage(sqlworker::Page& page, const QString& sqlQuery, int numRows)
+{
+  // Get one more row to find out if there is more
+  QString sql = sqlQuery;
+  if(numRows < 0)
+    sql += QString(" limit -1 offset %1").arg(page.offset);
+  else
+    sql += QString(" limit %1 offset %2").arg(numRows + 1).arg(page.offset);
+
+  QSqlQuery query(database);
+  query.setForwardOnly(true);
+
+  if(query.exec(sql))
+  {
+    int numCols = query.record().count();
+    bool more = false;
+    while(query.next())
+    {
+      if(numRows >= 0 && page.rows.size() >= numRows)
+      {
+        more = true;
+        break;
+      }
+
+      sqlworker::Row row(numCols);
+      for(int i = 0; i < numCols; i++)
+        row[i] = query.value(i);
+      page.rows.append(row);
+    }
+    page.atEnd = !more;
+
+    if(query.lastError().isValid())
+      page.error = query.lastError();
+  }
+  else
+    page.error = query.lastError();
+
+  // Reset statement to release the lock
+  query.finish();
+
+  return !isInterrupted(page.error);
+}
+
+bool SqlQueryWorker::countRows(sqlworker::Page& page, const QString& sqlCountQuery)
+{
+  QSqlQuery query(database);
+  query.setForwardOnly(true);
+
+  if(query.exec(sqlCountQuery) && query.next())
+    page.totalRowCount = query.value(0).toInt();
+  else
+    page.error = query.lastError();
+  query.finish();
+
+  if(isInterrupted(page.error))
+    return false;
+
+  if(page.error.isValid())
+  {
+    // Not critical - model shows number of loaded rows
+    qWarning() << Q_FUNC_INFO << "Cannot count rows" << sqlCountQuery << ":" << page.error.text();
+    return false;
+  }
+  return true;
+}
+
+void SqlQueryWorker::addPage(const sqlworker::Page& page)
+{
+  {
+    QMutexLocker locker(&mutex);
+    pages.append(page);
+  }
+  emit pagesAvailable();
+}
+
+void SqlQueryWorker::setBusy(qint64 generation)
+{
+  QMutexLocker locker(&mutex);
+  busyGeneration = generation;
+}
+
+bool SqlQueryWorker::isInterrupted(const QSqlError& error)
+{
+  return error.isValid() && error.nativeErrorCode() == QString::number(SQLITE_INTERRUPT);
+}
+
+bool SqlQueryWorker::openDatabase(const QString& databaseFile, QSqlError& error)
+{
+  if(database.isOpen() && database.databaseName() == databaseFile)
+    return true;
+
+  // Not opened yet or file changed after loading a scenery database or swapping the online database
+  closeDatabase();
+
+  database = QSqlDatabase::addDatabase(DATABASE_TYPE, connectionName);
+  database.setDatabaseName(databaseFile);
+  database.setConnectOptions("QSQLITE_OPEN_READONLY");
+
+  if(!database.open())
+  {
+    error = database.lastError();
+    qWarning() << Q_FUNC_INFO << "Cannot open" << databaseFile << ":" << error.text();
+    closeDatabase();
+    return false;
+  }
+
+  QVariant driverHandle = database.driver()->handle();
+  if(driverHandle.isValid() && qstrcmp(driverHandle.typeName(), "sqlite3*") == 0)
+  {
+    QMutexLocker locker(&mutex);
+    handle = *static_cast<sqlite3 **>(driverHandle.data());
+  }
+  else
+    qWarning() << Q_FUNC_INFO << "No SQLite handle. Queries cannot be interrupted.";
+
+  return true;
+}
+
+void SqlQueryWorker::closeDatabase()
+{
+  {
+    // Stop cancel() from using the handle
+    QMutexLocker locker(&mutex);
+    handle = nullptr;
+  }
+
+  if(database.isValid())
+  {
+    database.close();
+    database = QSqlDatabase();
+    QSqlDatabase::removeDatabase(connectionName);
+  }
+}
@@ -0,0 +1,137 @@
+/*****************************************************************************
+* Copyright 2015-2018 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_SQLQUERYWORKER_H
+#define LITTLENAVMAP_SQLQUERYWORKER_H
+
+#include <QMutex>
+#include <QObject>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QVariant>
+#include <QVector>
+
+#include <atomic>
+
+struct sqlite3;
+
+namespace sqlworker {
+
+/* Values of one result row in the order of the query columns */
+typedef QVector<QVariant> Row;
+typedef QVector<Row> RowVector;
+
+/* Number of rows fetched for each page */
+const int PAGE_SIZE = 256;
+
+/* Result of a fetchRows or count call in the worker thread */
+struct Page
+{
+  qint64 generation = 0; /* Query generation this page belongs to */
+  int offset = 0; /* Index of the first row in the complete result */
+  RowVector rows;
+  bool atEnd = false; /* No more rows follow this page */
+  int totalRowCount = -1; /* Result of the count query if not negative. Page contains no rows in this case. */
+  QSqlError error; /* Query failed if valid */
+};
+
+}
+
+/*
+ * Runs the search queries of a SqlModel in an own thread using a read-only connection to the database file.
+ *
+ * Queries are identified by a generation which is increased by the model for each new query. Calling cancel()
+ * with a newer generation drops all waiting requests of older generations and interrupts a running one
+ * using sqlite3_interrupt.
+ *
+ * Rows are fetched in pages using limit and offset. No statement is kept open between requests so the
+ * worker does not block writers of the user or online database.
+ *
+ * Pages are collected in a queue and pagesAvailable() is emitted for each one. The model picks them up
+ * in the GUI thread by calling takePages().
+ */
+class SqlQueryWorker :
+  public QObject
+{
+  Q_OBJECT
+
+public:
+  SqlQueryWorker();
+  virtual ~SqlQueryWorker();
+
+  /* Thread safe. All requests older than generation are outdated and a running query of these is
+   * interrupted. */
+  void cancel(qint64 generation);
+
+  /* Thread safe. Moves all collected pages into result. */
+  void takePages(QVector<sqlworker::Page>& result);
+
+  /*
+   * Fetch numRows rows of the query starting at offset or all remaining if numRows is negative.
+   * Runs the count query after the first page if the result does not fit into it.
+   * Call in the worker thread by using QMetaObject::invokeMethod.
+   */
+  Q_INVOKABLE void fetchRows(qint64 generation, const QString& databaseFile, const QString& sqlQuery,
+                             const QString& sqlCountQuery, int offset, int numRows);
+
+  /* Does nothing. Used with a blocking queued connection to wait for all requests sent before. */
+  Q_INVOKABLE void sync();
+
+  /* Close the connection. Will be opened again with the next request. */
+  Q_INVOKABLE void closeDatabase();
+
+signals:
+  /* One or more pages can be fetched with takePages() */
+  void pagesAvailable();
+
+private:
+  /* Opens the database if not already done or reopens it if the file has changed */
+  bool openDatabase(const QString& databaseFile, QSqlError& error);
+
+  /* Run query and fill page. Returns false if interrupted. */
+  bool fetchPage(sqlworker::Page& page, const QString& sqlQuery, int numRows);
+  bool countRows(sqlworker::Page& page, const QString& sqlCountQuery);
+
+  void addPage(const sqlworker::Page& page);
+  void setBusy(qint64 generation);
+
+  bool isOutdated(qint64 generation) const
+  {
+    return generation < latestGeneration.load();
+  }
+
+  /* True if the error was caused by cancel() */
+  static bool isInterrupted(const QSqlError& error);
+
+  QSqlDatabase database;
+  QString connectionName;
+
+  /* Protects handle, busyGeneration and pages */
+  QMutex mutex;
+
+  /* Native handle of the open database for sqlite3_interrupt or null if closed */
+  sqlite3 *handle = nullptr;
+
+  /* Generation of the running query or 0 if idle */
+  qint64 busyGeneration = 0;
+
+  QVector<sqlworker::Page> pages;
+
+  std::atomic<qint64> latestGeneration;
+};
+
+#endif // LITTLENAVMAP_SQLQUERYWORKER_H
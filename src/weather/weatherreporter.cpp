@@ -32,8 +32,10 @@
 #include "util/filesystemwatcher.h"
 #include "connect/connectclient.h"
 
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 #include <QNetworkRequest>
@@ -42,6 +44,7 @@
 #include <QTimer>
 #include <QRegularExpression>
 #include <QEventLoop>
+#include <QtConcurrent/QtConcurrentRun>
 
 // Checks the first line of an ASN file if it has valid content
 static const QRegularExpression ASN_VALIDATE_REGEXP("^[A-Z0-9]{3,4}::[A-Z0-9]{3,4} .+$");
@@ -55,6 +58,9 @@ using atools::fs::weather::MetarResult;
 using atools::fs::weather::Metar;
 using atools::util::FileSystemWatcher;
 
+/* Returned for missing reports */
+static const Metar EMPTY_METAR;
+
 WeatherReporter::WeatherReporter(MainWindow *parentWindow, atools::fs::FsPaths::SimulatorType type)
   : QObject(parentWindow), simType(type),
   mainWindow(parentWindow)
@@ -87,6 +93,10 @@ WeatherReporter::WeatherReporter(MainWindow *parentWindow, atools::fs::FsPaths::
   else
     ivaoWeather->setUpdatePeriod(-1);
 
+  // Notification from thread that the snapshot file was read
+  connect(&activeSkyWatcher, &QFutureWatcher<ActiveSkySnapshot>::finished,
+          this, &WeatherReporter::activeSkySnapshotLoaded);
+
   initActiveSkyNext();
 
   // Set callback so the reader can build an index for nearest airports
@@ -96,6 +106,9 @@ WeatherReporter::WeatherReporter(MainWindow *parentWindow, atools::fs::FsPaths::
   connect(xpWeatherReader, &atools::fs::weather::XpWeatherReader::weatherUpdated,
           this, &WeatherReporter::xplaneWeatherFileChanged);
 
+  // Parsed metars might be outdated - clear before any receiver of this signal redraws
+  connect(this, &WeatherReporter::weatherUpdated, this, &WeatherReporter::clearMetarCache);
+
   // Forward signals from clients
   connect(noaaWeather, &WeatherNetSingle::weatherUpdated, this, &WeatherReporter::weatherUpdated);
   connect(vatsimWeather, &WeatherNetSingle::weatherUpdated, this, &WeatherReporter::weatherUpdated);
@@ -104,6 +117,9 @@ WeatherReporter::WeatherReporter(MainWindow *parentWindow, atools::fs::FsPaths::
 
 WeatherReporter::~WeatherReporter()
 {
+  activeSkyWatcher.disconnect();
+  activeSkyFuture.waitForFinished();
+
   deleteFsWatcher();
   delete noaaWeather;
   delete vatsimWeather;
@@ -216,6 +232,8 @@ void WeatherReporter::initActiveSkyNext()
 
   activeSkyType = NONE;
   activeSkyMetars.clear();
+  activeSkySnapshotHash.clear();
+  activeSkyReloadPending = false;
   activeSkyDepartureMetar.clear();
   activeSkyDestinationMetar.clear();
   activeSkyDepartureIdent.clear();
@@ -286,8 +304,56 @@ void WeatherReporter::initActiveSkyNext()
   }
 }
 
-/* Loads complete ASN file into a hash map */
+/* Starts loading of the complete ASN file into a hash map in background */
 void WeatherReporter::loadActiveSkySnapshot(const QString& path)
+{
+  // TODO overrride with settings
+  if(path.isEmpty())
+    return;
+
+  if(activeSkyLoading)
+  {
+    // Read again once the thread has finished
+    activeSkyReloadPending = true;
+    return;
+  }
+
+  // Start thread - hash is copied to avoid synchronization problems
+  activeSkyLoading = true;
+  activeSkyFuture = QtConcurrent::run(&WeatherReporter::readActiveSkySnapshot, path, activeSkySnapshotHash);
+
+  // Watcher will call activeSkySnapshotLoaded when finished
+  activeSkyWatcher.setFuture(activeSkyFuture);
+}
+
+/* Called by watcher when the thread is finished */
+void WeatherReporter::activeSkySnapshotLoaded()
+{
+  ActiveSkySnapshot snapshot = activeSkyFuture.result();
+  activeSkyLoading = false;
+
+  if(activeSkyReloadPending)
+  {
+    // File changed again while reading - start over
+    activeSkyReloadPending = false;
+    loadActiveSkySnapshot(asPath);
+  }
+
+  // Ignore results for files which are not used anymore after changing options or simulator
+  if(snapshot.path != asPath || !snapshot.valid || snapshot.unchanged)
+    return;
+
+  // Swap in the new station map and drop the old one
+  activeSkyMetars.swap(snapshot.metars);
+  activeSkySnapshotHash = snapshot.hash;
+
+  mainWindow->setStatusMessage(tr("Active Sky weather information updated."));
+  emit weatherUpdated();
+}
+
+/* Reads the complete ASN file into a hash map. Runs in background thread. */
+WeatherReporter::ActiveSkySnapshot WeatherReporter::readActiveSkySnapshot(const QString& path,
+                                                                          const QByteArray& lastHash)
 {
   // ASN
   // C:\Users\USER\AppData\Roaming\HiFi\ASNFSX\Weather\current_wx_snapshot.txt or wx_station_list.txt
@@ -298,16 +364,29 @@ void WeatherReporter::loadActiveSkySnapshot(const QString& path)
   // 34010KT 9999 -SH SCT019 SCT03 FM271200 VRB03KT 9999 -SH FEW017 SCT028 PROB30 INTER 2703/27010 5000 TSSH SCT016 FEW017CB BKN028
   // T 25 27 31 32 Q 1009 1011 1011 1009::278,11,24.0/267,12,19.0/263,13,16.1/233,12,7.2/290,7,-3.0/338,8,-13.0/348,18,-27.9/9,19,-37.9/26,15,-51.3
 
-  // TODO overrride with settings
-  if(path.isEmpty())
-    return;
+  ActiveSkySnapshot snapshot;
+  snapshot.path = path;
+
+  QElapsedTimer timer;
+  timer.start();
 
   QFile file(path);
   if(file.open(QIODevice::ReadOnly | QIODevice::Text))
   {
-    activeSkyMetars.clear();
+    QByteArray content = file.readAll();
+    file.close();
+    snapshot.valid = true;
+
+    // Active Sky often writes the file without changing the content - skip parsing in this case
+    snapshot.hash = QCryptographicHash::hash(content, QCryptographicHash::Md5);
+    if(snapshot.hash == lastHash)
+    {
+      snapshot.unchanged = true;
+      qDebug() << Q_FUNC_INFO << "Skipping unchanged" << path;
+      return snapshot;
+    }
 
-    QTextStream weatherSnapshot(&file);
+    QTextStream weatherSnapshot(&content, QIODevice::ReadOnly);
 
     int lineNum = 1;
     QString line;
@@ -315,18 +394,22 @@ void WeatherReporter::loadActiveSkySnapshot(const QString& path)
     {
       QStringList list = line.split("::");
       if(list.size() >= 2)
-        activeSkyMetars.insert(list.at(0), list.at(1));
+        snapshot.metars.insert(list.at(0), list.at(1));
       else
       {
-        qWarning() << "AS file" << file.fileName() << "has invalid entries";
+        qWarning() << "AS file" << path << "has invalid entries";
         qWarning() << "line #" << lineNum << line;
       }
       lineNum++;
     }
-    file.close();
+
+    qDebug() << Q_FUNC_INFO << "Read" << snapshot.metars.size() << "stations from" << path
+             << "in" << timer.elapsed() << "ms";
   }
   else
     qWarning() << "cannot open" << file.fileName() << "reason" << file.errorString();
+
+  return snapshot;
 }
 
 /* Loads flight plan weather for start and destination */
@@ -531,16 +614,17 @@ atools::fs::weather::MetarResult WeatherReporter::getIvaoMetar(const QString& ai
   return ivaoWeather->getMetar(airportIcao, pos);
 }
 
-atools::fs::weather::Metar WeatherReporter::getAirportWeather(const QString& airportIcao,
-                                                              const atools::geo::Pos& airportPos,
-                                                              map::MapWeatherSource source)
+const atools::fs::weather::Metar& WeatherReporter::getAirportWeather(const QString& airportIcao,
+                                                                     const atools::geo::Pos& airportPos,
+                                                                     map::MapWeatherSource source)
 {
   switch(source)
   {
     case map::WEATHER_SOURCE_SIMULATOR:
       if(NavApp::getCurrentSimulatorDb() == atools::fs::FsPaths::XPLANE11)
-        // X-Plane weather file
-        return Metar(getXplaneMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
+        // X-Plane weather file - station is not needed for the key since it is part of the metar
+        return getParsedMetar(QString(), source,
+                              getXplaneMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
       else if(NavApp::getConnectClient()->isConnected() /*&& !NavApp::getConnectClient()->isConnectedNetwork()*/)
       {
         atools::fs::weather::MetarResult res =
@@ -548,23 +632,49 @@ atools::fs::weather::Metar WeatherReporter::getAirportWeather(const QString& air
 
         if(res.isValid() && !res.metarForStation.isEmpty())
           // FSX/P3D - Flight simulator fetched weather or network connection
-          return Metar(res.metarForStation, res.requestIdent, res.timestamp, true);
+          return getParsedMetar(res.requestIdent, source, res.metarForStation, res.timestamp, true);
       }
-      return Metar();
+      return EMPTY_METAR;
 
     case map::WEATHER_SOURCE_ACTIVE_SKY:
-      return Metar(getActiveSkyMetar(airportIcao));
+      return getParsedMetar(QString(), source, getActiveSkyMetar(airportIcao));
 
     case map::WEATHER_SOURCE_NOAA:
-      return Metar(getNoaaMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
+      return getParsedMetar(QString(), source, getNoaaMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
 
     case map::WEATHER_SOURCE_VATSIM:
-      return Metar(getVatsimMetar(airportIcao));
+      return getParsedMetar(QString(), source, getVatsimMetar(airportIcao));
 
     case map::WEATHER_SOURCE_IVAO:
-      return Metar(getIvaoMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
+      return getParsedMetar(QString(), source, getIvaoMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
   }
-  return Metar();
+  return EMPTY_METAR;
+}
+
+const atools::fs::weather::Metar& WeatherReporter::getParsedMetar(const QString& station,
+                                                                  map::MapWeatherSource source,
+                                                                  const QString& metar, const QDateTime& timestamp,
+                                                                  bool fsMetar)
+{
+  if(metar.isEmpty())
+    return EMPTY_METAR;
+
+  MetarCacheEntry& entry = metarCache[MetarCacheKey{station, source, qHash(metar)}];
+
+  if(entry.metar != metar || entry.timestamp != timestamp || entry.fsMetar != fsMetar)
+  {
+    // New entry, changed timestamp or hash collision - parse and replace
+    entry.metar = metar;
+    entry.timestamp = timestamp;
+    entry.fsMetar = fsMetar;
+    entry.parsed = Metar(metar, station, timestamp, fsMetar);
+  }
+  return entry.parsed;
+}
+
+void WeatherReporter::clearMetarCache()
+{
+  metarCache.clear();
 }
 
 void WeatherReporter::preDatabaseLoad()
@@ -580,6 +690,7 @@ void WeatherReporter::postDatabaseLoad(atools::fs::FsPaths::SimulatorType type)
     simType = type;
     initActiveSkyNext();
     initXplane();
+    clearMetarCache();
   }
 }
 
@@ -597,17 +708,24 @@ void WeatherReporter::optionsChanged()
 
   initActiveSkyNext();
   initXplane();
+  clearMetarCache();
 }
 
 void WeatherReporter::activeSkyWeatherFileChanged(const QString& path)
 {
   Q_UNUSED(path);
   qDebug() << Q_FUNC_INFO << "file" << path << "changed";
+  QString lastDepartureMetar = activeSkyDepartureMetar, lastDestinationMetar = activeSkyDestinationMetar;
+
+  // Snapshot is read in background and sends weatherUpdated itself if changed
   loadActiveSkySnapshot(asPath);
   loadActiveSkyFlightplanSnapshot(asFlightplanPath);
-  mainWindow->setStatusMessage(tr("Active Sky weather information updated."));
 
-  emit weatherUpdated();
+  if(lastDepartureMetar != activeSkyDepartureMetar || lastDestinationMetar != activeSkyDestinationMetar)
+  {
+    mainWindow->setStatusMessage(tr("Active Sky weather information updated."));
+    emit weatherUpdated();
+  }
 }
 
 void WeatherReporter::xplaneWeatherFileChanged()
@@ -20,7 +20,11 @@
 
 #include "fs/fspaths.h"
 #include "common/mapflags.h"
+#include "fs/weather/metar.h"
 
+#include <QDateTime>
+#include <QFuture>
+#include <QFutureWatcher>
 #include <QHash>
 #include <QObject>
 
@@ -36,8 +40,6 @@ namespace fs {
 namespace weather {
 struct MetarResult;
 
-class Metar;
-
 class WeatherNetSingle;
 class WeatherNetDownload;
 class XpWeatherReader;
@@ -96,9 +98,21 @@ public:
    */
   atools::fs::weather::MetarResult getIvaoMetar(const QString& airportIcao, const atools::geo::Pos& pos);
 
-  /* For display. Source depends on settings and parsed objects are cached. */
-  atools::fs::weather::Metar getAirportWeather(const QString& airportIcao, const atools::geo::Pos& airportPos,
-                                               map::MapWeatherSource source);
+  /* For display. Source depends on settings and parsed objects are cached.
+   * Returned reference is valid until the cache is cleared. */
+  const atools::fs::weather::Metar& getAirportWeather(const QString& airportIcao, const atools::geo::Pos& airportPos,
+                                                      map::MapWeatherSource source);
+
+  /*
+   * Get a parsed metar from the cache or parse and add it. Cache key is station, source and metar string.
+   * The cache is cleared whenever weather is updated. Returned reference is valid until the cache is cleared.
+   */
+  const atools::fs::weather::Metar& getParsedMetar(const QString& station, map::MapWeatherSource source,
+                                                   const QString& metar, const QDateTime& timestamp = QDateTime(),
+                                                   bool fsMetar = false);
+
+  /* Remove all parsed metars. Called for weatherUpdated of this and the simulator connection. */
+  void clearMetarCache();
 
   /* Does nothing currently */
   void preDatabaseLoad();
@@ -159,10 +173,26 @@ signals:
   void weatherUpdated();
 
 private:
+  /* Result of reading an Active Sky snapshot file in a background thread */
+  struct ActiveSkySnapshot
+  {
+    QString path;
+    QByteArray hash; /* MD5 of the file content */
+    QHash<QString, QString> metars; /* Station ident to metar */
+    bool valid = false, /* File could be read */
+         unchanged = false; /* Hash is equal to the one of the last loaded file - metars are empty */
+  };
+
   void activeSkyWeatherFileChanged(const QString& path);
   void xplaneWeatherFileChanged();
 
+  /* Starts reading the file in background. activeSkySnapshotLoaded is called when done. */
   void loadActiveSkySnapshot(const QString& path);
+  void activeSkySnapshotLoaded();
+
+  /* Runs in background thread */
+  static ActiveSkySnapshot readActiveSkySnapshot(const QString& path, const QByteArray& lastHash);
+
   void loadActiveSkyFlightplanSnapshot(const QString& path);
   void initActiveSkyNext();
   void findActiveSkyFiles(QString& asnSnapshot, QString& flightplanSnapshot, const QString& activeSkyPrefix,
@@ -176,11 +206,46 @@ private:
   static void noaaIndexParser(QString& icao, QDateTime& lastUpdate, const QString& line);
   static atools::geo::Pos fetchAirportCoordinates(const QString& airportIdent);
 
+  /* Key for parsed metar cache */
+  struct MetarCacheKey
+  {
+    QString station;
+    map::MapWeatherSource source;
+    uint metarHash;
+
+    bool operator==(const MetarCacheKey& other) const
+    {
+      return metarHash == other.metarHash && source == other.source && station == other.station;
+    }
+
+    friend uint qHash(const MetarCacheKey& key)
+    {
+      return qHash(key.station) ^ static_cast<uint>(key.source) ^ key.metarHash;
+    }
+
+  };
+
+  /* Cached metar and values needed to detect hash collisions */
+  struct MetarCacheEntry
+  {
+    QString metar;
+    QDateTime timestamp;
+    bool fsMetar = false;
+    atools::fs::weather::Metar parsed;
+  };
+
   atools::fs::weather::WeatherNetSingle *noaaWeather = nullptr;
   atools::fs::weather::WeatherNetSingle *vatsimWeather = nullptr;
   atools::fs::weather::WeatherNetDownload *ivaoWeather = nullptr;
 
   QHash<QString, QString> activeSkyMetars;
+
+  /* Reads Active Sky snapshot file in background */
+  QFuture<ActiveSkySnapshot> activeSkyFuture;
+  QFutureWatcher<ActiveSkySnapshot> activeSkyWatcher;
+  QByteArray activeSkySnapshotHash;
+  bool activeSkyLoading = false; /* Thread is reading - set on start and cleared in activeSkySnapshotLoaded */
+  bool activeSkyReloadPending = false; /* File changed while the thread was still reading */
   QString activeSkyDepartureMetar, activeSkyDestinationMetar,
           activeSkyDepartureIdent, activeSkyDestinationIdent;
 
@@ -199,6 +264,9 @@ private:
   /* Update online reports if older than 10 minutes */
   int onlineWeatherTimeoutSecs = 600;
 
+  /* Parsed metars for map display, information and tooltips */
+  QHash<MetarCacheKey, MetarCacheEntry> metarCache;
+
 };
 
 #endif // LITTLENAVMAP_WEATHERREPORTER_H